@@ -3,10 +3,15 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <algorithm>
 
 #include "core/stacktrace.hpp"
 #include "core/logger.hpp"
 #include "render/debugrenderer.hpp"
+#include "ecs/commandbuffer.hpp"
+#include "ecs/snapshot.hpp"
+#include "scene/transform.hpp"
+#include "physics/rigidbody.hpp"
 #include "defaults.hpp"
 #include "input/input.hpp"
 #include "utils/resourcemanager.hpp"
@@ -53,8 +58,14 @@ namespace Engine {
         mWindow = new Core::Window(settings.windowWidth, settings.windowHeight, settings.title.c_str());
         mRenderTarget = new Render::RenderTarget(width, height, settings.resolutionScaling);
         mRenderer = new Render::ScreenRenderer();
+        mJobSystem = new Core::JobSystem(settings.workerThreads);
+        mScheduler = new ECS::SystemScheduler(*mJobSystem);
         mFrameCounter = 0;
 
+        // Composants du moteur inclus dans les snapshots du registre (voir ECS::Snapshot)
+        ECS::Snapshot::RegisterComponent<Scene::Transform>("Transform");
+        ECS::Snapshot::RegisterComponent<Physics::Rigidbody>("Rigidbody");
+
         // Initialisation et traitement OpenGL/GLFW avant d'entrer dans la boucle de l'appli
         glfwSetWindowUserPointer(mWindow->GetRawContext(), this); // Bind un pointeur vers l'App dans le contexte glfw pour accès dans les callbacks
         glfwSetFramebufferSizeCallback(mWindow->GetRawContext(), FramebufferSizeCallbackFitToApp);
@@ -64,6 +75,11 @@ namespace Engine {
         Audio::AudioManager::Init();
     }
 
+    App::~App() {
+        delete mScheduler;
+        delete mJobSystem;
+    }
+
     int App::GetWidth() { return mWidth; }
     int App::GetHeight() { return mHeight; }
     void App::SetSize(int width, int height, bool adjustCamera) {
@@ -86,6 +102,7 @@ namespace Engine {
     float App::GetFPS() { return mFrameCounter; }
 
     Core::Window* App::GetWindow() { return mWindow; }
+    Core::JobSystem& App::GetJobSystem() { return *mJobSystem; }
     Render::RenderTarget* App::GetRenderTarget() { return mRenderTarget; }
     Scene::Scene* App::GetCurrentScene() { return mCurrentScene; }
     Scene::ICamera* App::GetCurrentCamera() { return mCurrentScene ? mCurrentScene->GetCamera() : nullptr; }
@@ -126,6 +143,8 @@ namespace Engine {
         
         for(auto [_, system]: mSystems) {
             system->mRegistry = mCurrentScene->GetRegistry();
+            system->mLastRunTick = 0;
+            std::fill(std::begin(system->mPhaseTicks), std::end(system->mPhaseTicks), 0);
         }
         mCurrentScene->OnEnter();
 
@@ -144,7 +163,11 @@ namespace Engine {
 
         // Fixed timestep
         float fixedStepAccumulator = 0.0f;
-        float fixedStep = 1.0f / FIXED_STEP_FRAMERATE;
+        if(settings.fixedStepFramerate <= 0.0f) {
+            LOG_WARNING("AppSettings::fixedStepFramerate must be positive, falling back to " + std::to_string(FIXED_STEP_FRAMERATE));
+            settings.fixedStepFramerate = FIXED_STEP_FRAMERATE;
+        }
+        const float fixedStep = 1.0f / settings.fixedStepFramerate;
         const float maxAccumulator = fixedStep * 5;
 
         // FPS Counter
@@ -188,8 +211,9 @@ namespace Engine {
 
             /* INIT (une fois seulement au chargement de la scène. LoadScene remets le booléen à false donc changer de scène appelle OnInit sur tous les systèmes) */
             if(!mInitialized) {
-                for(auto [_, system]: mSystems) { system->OnInit(); }
+                for(auto system : mScheduler->GetSystems()) { system->OnInit(); }
                 if(mCurrentScene) { mCurrentScene->OnInit(); }
+                mCurrentScene->GetRegistry()->FlushCommands();
                 mInitialized = true;
             }
             
@@ -207,22 +231,28 @@ namespace Engine {
             // Une update fixée à un timing donné (accumulateur qui trigger ou non l'update à chaque boucle)
             fixedStepAccumulator = (fixedStepAccumulator + deltaTime) < maxAccumulator ? (fixedStepAccumulator + deltaTime) : maxAccumulator;
             while(fixedStepAccumulator >= fixedStep) {
-                for(auto [_, system]: mSystems) { system->OnFixedUpdate(fixedStep); }
+                mScheduler->Run(ECS::SystemPhase::FixedUpdate, fixedStep, settings.parallelSystems);
                 if(mCurrentScene) { mCurrentScene->OnFixedUpdate(fixedStep); }
+                mCurrentScene->GetRegistry()->FlushCommands(); // Point de synchronisation : applique les changements structurels différés
                 fixedStepAccumulator -= fixedStep;
             }
 
             /* UPDATE VARIABLE */
-            for(auto [_, system]: mSystems) { if(!system->IsPaused()) system->OnUpdate(deltaTime); }
+            mScheduler->Run(ECS::SystemPhase::Update, deltaTime, settings.parallelSystems);
             if(mCurrentScene) { mCurrentScene->OnUpdate(deltaTime); }
             if(GetCurrentCamera()) { GetCurrentCamera()->OnUpdate(deltaTime); }
+            mCurrentScene->GetRegistry()->FlushCommands();
+
+            /* PRE RENDER */
+            // Tout ce qui devait bouger dans la frame a bougé : les données lues par le rendu sont préparées ici (cache des transforms monde)
+            mScheduler->Run(ECS::SystemPhase::PreRender, deltaTime, settings.parallelSystems);
 
             /* RENDER */
             mRenderTarget->Bind();
             mWindow->Clear(settings.clearColor);
 
             float alpha = fixedStepAccumulator / fixedStep;
-            for(auto [_, system]: mSystems) { if(!system->IsPaused()) system->OnRender(alpha); }
+            for(auto system : mScheduler->GetSystems()) { if(!system->IsPaused()) system->OnRender(alpha); }
             if(mCurrentScene) { mCurrentScene->OnRender(alpha); }
 
             mRenderTarget->Unbind();
@@ -230,15 +260,21 @@ namespace Engine {
             mRenderer->RenderToScreen(*mRenderTarget);
 
             /* UI RENDER (par dessus le rendu écran !) */
-            for(auto [_, system]: mSystems) { if(!system->IsPaused()) system->OnUIRender(); }
+            for(auto system : mScheduler->GetSystems()) { if(!system->IsPaused()) system->OnUIRender(); }
             if(mCurrentScene) { mCurrentScene->OnUIRender(); }
 
             // Swap des buffers de mWindow pour acter le rendu
             mWindow->SwapBuffers();
 
             /* LATE UPDATE */
-            for(auto [_, system]: mSystems) { if(!system->IsPaused()) system->OnLateUpdate(deltaTime); }
+            mScheduler->Run(ECS::SystemPhase::LateUpdate, deltaTime, settings.parallelSystems);
             if(mCurrentScene) { mCurrentScene->OnLateUpdate(deltaTime); }
+            mCurrentScene->GetRegistry()->FlushCommands();
+
+            // Les évènements de composants déjà lus par tous les systèmes sont oubliés (un système en pause ne les retient pas)
+            ChangeTick seen = mCurrentScene->GetRegistry()->GetChangeTick();
+            for(auto system : mScheduler->GetSystems()) { if(!system->IsPaused()) seen = std::min(seen, system->GetConsumedTick()); }
+            mCurrentScene->GetRegistry()->TrimEvents(seen);
 
             /* SLEEP IF WE ARE AHEAD OF TIME (basé sur le settings.fpsLimit de App, ignoré si fpsLimit <= 0) */
             if(settings.fpsLimit > 0) {
@@ -17,8 +17,10 @@
 #include "ecs/entity.hpp"
 #include "ecs/registry.hpp"
 #include "ecs/system.hpp"
+#include "ecs/scheduler.hpp"
 
 #include "core/window.hpp"
+#include "core/jobsystem.hpp"
 #include "input/input.hpp"
 #include "audio/audiomanager.hpp"
 #include "scene/scene.hpp"
@@ -42,6 +44,10 @@ namespace Engine {
             // ECS
             /** @brief Liste des systèmes actuellement chargés dans l'applicaiton */
             std::unordered_map<std::type_index, ECS::System*> mSystems;
+            /** @brief Exécute les systèmes dans leur ordre d'enregistrement, en parallèle quand leurs accès le permettent */
+            ECS::SystemScheduler* mScheduler;
+            /** @brief Threads de travail du moteur, partagés par l'ordonnanceur et le code utilisateur (voir GetJobSystem) */
+            Core::JobSystem* mJobSystem;
             /** @brief Liste des scènes à disposition dans l'application */
             std::unordered_map<std::string, std::function<Scene::Scene*()>> mSceneFactories;
             // Garde en mémoire le nom de la scène à charger (après un appel à LoadScene())
@@ -95,6 +101,19 @@ namespace Engine {
                  * Ce paramètre n'influence pas la boucle FixedUpdate qui a son propre framerate interne
                  */
                 int fpsLimit = 60;
+                /**
+                 * @brief Fréquence de la boucle FixedUpdate (physique), en pas par seconde
+                 * Le rendu interpole les rigidbodies entre deux pas (voir Physics::Rigidbody::interpolate) : une fréquence
+                 * plus basse que celle de l'écran reste fluide, et coûte moins cher en physique
+                 */
+                float fixedStepFramerate = FIXED_STEP_FRAMERATE;
+                /**
+                 * @brief Exécute en parallèle les systèmes qui n'accèdent pas aux mêmes composants (voir ECS::SystemScheduler)
+                 * Si false, tous les systèmes sont exécutés sur le thread principal, dans le même ordre et avec le même résultat
+                 */
+                bool parallelSystems = true;
+                /** @brief Nombre de threads de travail du JobSystem en plus du thread principal (0 => nombre de coeurs - 1) */
+                unsigned int workerThreads = 0;
             } settings;
 
             /** @brief Store global de l'application */
@@ -108,13 +127,16 @@ namespace Engine {
              * @param settings Un objet AppSettings pour configurer l'appli
              */
             App(int width = 800, int height = 600, AppSettings settings = {"App"});
+            /** @brief Arrête les threads de travail de l'application */
+            ~App();
             /**
              * @brief Lance la boucle principale de l'application
              * 
              * Run() contient une boucle semi-infinie qui ne s'arrête que lorsque l'on met un terme 
              * à l'éxecution du contexte OpenGL. Chaque itération appelle les fonctions du cycle de vie de l'app. 
              * 
-             * Dans l'ordre : OnInit (si !mInitialized) > OnFixedUpdate > OnUpdate > OnRender > OnUIRender > OnLateUpdate
+             * Dans l'ordre : OnInit (si !mInitialized) > OnFixedUpdate > OnUpdate > OnPreRender > OnRender > OnUIRender > OnLateUpdate
+             * Pour chaque phase, les systèmes sont appelés dans leur ordre d'enregistrement (voir ECS::SystemScheduler)
              */
             void Run();
             /** @brief Demande la fermeture du contexte opengl (et par exetnsion met un terme à la boucle Run) */
@@ -126,6 +148,12 @@ namespace Engine {
              * @return Core::Window* 
              */
             Core::Window* GetWindow();
+            /**
+             * @brief Renvoie le système de tâches du moteur (pour paralléliser du travail dans les systèmes ou les scènes)
+             * 
+             * @return Core::JobSystem& 
+             */
+            Core::JobSystem& GetJobSystem();
             /**
              * @brief Renvoie un pointeur vers la renderTarget utilisée pour le screenRenderer
              * 
@@ -222,6 +250,7 @@ namespace Engine {
                 mSystems[ti] = new T(args...);
                 mSystems[ti]->mApp = this;
                 if(mCurrentScene) mSystems[ti]->mRegistry = mCurrentScene->GetRegistry();
+                mScheduler->Add(mSystems[ti]);
 
                 return static_cast<T&>(*mSystems[ti]);
             }
@@ -262,7 +291,9 @@ namespace Engine {
                 std::type_index ti(typeid(T));
                 if(mSystems.find(ti) == mSystems.end()) throw std::runtime_error("App::UnregisterSystem: Can not unregister an already unregistered system");
 
+                mScheduler->Remove(mSystems[ti]);
                 delete mSystems[ti];
+                mSystems.erase(ti);
             }
     };
 }
\ No newline at end of file
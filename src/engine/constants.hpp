@@ -7,9 +7,52 @@
 #include <cstdint>
 #include <bitset>
 
+#include "defs.hpp"
+
 namespace Engine {
-    /** @brief Définition du maximum d'entités qui peuvent exister dans une scène */
-    constexpr std::size_t MAX_ENTITIES = 5000;
+    /**
+     * @brief Définition du maximum d'entités qui peuvent exister dans une scène
+     * 
+     * C'est une limite, pas une allocation : le registre n'alloue de place que pour les entités réellement créées.
+     * Tous les index qui tiennent dans un EntityID sont utilisables (ENTITY_INDEX_MASK est réservé aux index libres).
+     */
+    constexpr std::size_t MAX_ENTITIES = ENTITY_INDEX_MASK;
+    /** @brief Nombre d'entités par page dans les tableaux du registre indexés par EntityIndex (voir ECS::PagedArray) */
+    constexpr std::size_t ENTITY_PAGE_SIZE = 1024;
+    /** @brief Nombre maximum de types de composants différents (taille des signatures d'entités) */
+    constexpr std::size_t MAX_COMPONENTS = 64;
+    /**
+     * @brief Signature d'une entité : le bit i est à 1 si l'entité possède un composant dont le type a l'identifiant i
+     * 
+     * Avec 64 types, une signature tient dans un seul mot machine : tester un ensemble de composants est un simple AND.
+     */
+    using Signature = std::bitset<MAX_COMPONENTS>;
+    /** @brief Nombre maximum de tags différents (voir ECS::InternTag) */
+    constexpr std::size_t MAX_TAGS = 64;
+    /** @brief Tags d'une entité : le bit i est à 1 si l'entité possède le tag d'identifiant i */
+    using TagMask = std::bitset<MAX_TAGS>;
+    /**
+     * @brief Nombre de composants par page dans les stockages compacts de l'ECS
+     * 
+     * Les composants sont rangés dans des pages de taille fixe : agrandir un stockage ajoute une page
+     * sans déplacer les composants existants (les références restent valides lors d'un ajout).
+     */
+    constexpr std::size_t COMPONENT_PAGE_SIZE = 1024;
+    /**
+     * @brief Taille d'un chunk d'archétype en octets (backend StorageBackend::Archetype)
+     * 
+     * Chaque chunk contient les composants de plusieurs entités d'un même archétype, rangés colonne par colonne.
+     * 16 Ko permettent de garder un chunk entier dans le cache L1 de la plupart des processeurs.
+     */
+    constexpr std::size_t ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+    /** @brief Alignement des chunks d'archétypes (taille d'une ligne de cache) */
+    constexpr std::size_t ARCHETYPE_CHUNK_ALIGNMENT = 64;
+    /**
+     * @brief Nombre de composants par bloc dans les pools des composants polymorphiques (Behaviour)
+     * 
+     * Chaque type concret a son propre pool : un bloc est alloué d'un coup, puis découpé en emplacements réutilisables.
+     */
+    constexpr std::size_t COMPONENT_POOL_BLOCK_SIZE = 64;
     constexpr float COLLISION_EXPIRE_THRESHOLD = 0.1f;
     constexpr float PHYSICS_SLEEP_SPEED_THRESHOLD = 0.5f;
     constexpr float PHYSICS_SLEEP_TIME_THREHSOLD = 1.0f;
@@ -42,4 +85,11 @@ namespace Engine {
      * A l'inverse, un trop grand nombre ici crééra d'immenses cellules qui regrouperaient trop d'entités.
      */
     constexpr float SPATIAL_HASH_CELL_SIZE = 250.0f;
+    /**
+     * @brief Marge ajoutée autour des AABB rangées dans un arbre d'AABB (en unités du monde)
+     * 
+     * Une entité qui bouge sans sortir de sa boîte élargie ne déplace rien dans l'arbre.
+     * Une marge trop grande crée en revanche des paires inutiles pour les tests de collision.
+     */
+    constexpr float AABB_TREE_FAT_MARGIN = 10.0f;
 }
\ No newline at end of file
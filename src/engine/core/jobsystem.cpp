@@ -0,0 +1,140 @@
+#include "jobsystem.hpp"
+
+namespace Engine::Core {
+    namespace {
+        /** @brief Le système de tâches du thread de travail courant (nullptr pour un thread extérieur) */
+        thread_local const JobSystem* tOwner = nullptr;
+        /** @brief L'index de la file du thread de travail courant */
+        thread_local std::size_t tQueueIndex = 0;
+    }
+
+    JobSystem::JobSystem(unsigned int workerThreads) {
+        if(workerThreads == 0) {
+            unsigned int cores = std::thread::hardware_concurrency();
+            workerThreads = cores > 1 ? cores - 1 : 0;
+        }
+
+        for(unsigned int i = 0; i <= workerThreads; ++i) mQueues.push_back(std::make_unique<WorkQueue>());
+        for(unsigned int i = 0; i < workerThreads; ++i) mWorkers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard lock(mSleepMutex);
+            mStopping = true;
+        }
+        mWake.notify_all();
+
+        for(auto& worker : mWorkers) worker.join();
+    }
+
+    std::size_t JobSystem::QueueIndex() const {
+        return tOwner == this ? tQueueIndex : 0;
+    }
+
+    JobHandle JobSystem::Schedule(std::function<void()> task, std::initializer_list<JobHandle> dependencies) {
+        auto job = std::make_shared<JobHandle::Job>();
+        job->task = std::move(task);
+
+        for(const JobHandle& dependency : dependencies) {
+            if(!dependency.mJob) continue;
+
+            std::lock_guard lock(dependency.mJob->mutex);
+            if(!dependency.mJob->finished.load(std::memory_order_relaxed)) {
+                dependency.mJob->dependents.push_back(job);
+                job->dependencies++;
+            }
+        }
+
+        // Retire le +1 de planification : la tâche est prête si toutes ses dépendances étaient déjà terminées
+        if(--job->dependencies == 0) Push(job);
+
+        return JobHandle(job);
+    }
+
+    void JobSystem::Push(JobPtr job) {
+        WorkQueue& queue = *mQueues[QueueIndex()];
+        {
+            std::lock_guard lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+        }
+        mQueued++;
+
+        // Passer par le mutex évite de réveiller un thread entre son test et son attente (réveil perdu)
+        { std::lock_guard lock(mSleepMutex); }
+        mWake.notify_one();
+    }
+
+    JobSystem::JobPtr JobSystem::Pop(std::size_t queueIndex) {
+        {
+            WorkQueue& own = *mQueues[queueIndex];
+            std::lock_guard lock(own.mutex);
+            if(!own.jobs.empty()) {
+                JobPtr job = std::move(own.jobs.back());
+                own.jobs.pop_back();
+                mQueued--;
+                return job;
+            }
+        }
+
+        for(std::size_t i = 1; i < mQueues.size(); ++i) {
+            WorkQueue& victim = *mQueues[(queueIndex + i) % mQueues.size()];
+            std::lock_guard lock(victim.mutex);
+            if(!victim.jobs.empty()) {
+                JobPtr job = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                mQueued--;
+                return job;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void JobSystem::Execute(const JobPtr& job) {
+        try {
+            job->task();
+        } catch(...) {
+            job->error = std::current_exception();
+        }
+        job->task = nullptr;
+
+        std::vector<JobPtr> dependents;
+        {
+            std::lock_guard lock(job->mutex);
+            job->finished.store(true, std::memory_order_release);
+            dependents.swap(job->dependents);
+        }
+
+        for(JobPtr& dependent : dependents) {
+            if(--dependent->dependencies == 0) Push(std::move(dependent));
+        }
+    }
+
+    void JobSystem::WorkerLoop(std::size_t queueIndex) {
+        tOwner = this;
+        tQueueIndex = queueIndex;
+
+        while(true) {
+            if(JobPtr job = Pop(queueIndex)) {
+                Execute(job);
+                continue;
+            }
+
+            std::unique_lock lock(mSleepMutex);
+            mWake.wait(lock, [this]() { return mStopping || mQueued > 0; });
+            if(mStopping) return;
+        }
+    }
+
+    void JobSystem::Wait(const JobHandle& handle) {
+        std::size_t queueIndex = QueueIndex();
+
+        while(!handle.IsDone()) {
+            if(JobPtr job = Pop(queueIndex)) Execute(job);
+            else std::this_thread::yield();
+        }
+
+        if(handle.mJob && handle.mJob->error) std::rethrow_exception(handle.mJob->error);
+    }
+}
@@ -0,0 +1,214 @@
+/**
+ * @file jobsystem.hpp
+ * @brief Système de tâches (jobs) du moteur : un thread de travail par coeur, avec vol de tâches entre threads
+ * 
+ * Chaque thread de travail possède sa propre file de tâches : il dépile ses tâches par la fin (les plus récentes, encore
+ * chaudes dans le cache), et quand sa file est vide il vole les tâches les plus anciennes des autres files.
+ * Les tâches planifiées depuis un thread extérieur (le thread principal) vont dans une file partagée, volée de la même façon.
+ * 
+ * Utilisation :
+ *   auto a = jobs.Schedule([]() { ... });
+ *   auto b = jobs.Schedule([]() { ... }, {a}); // b ne démarre qu'une fois a terminée
+ *   jobs.Wait(b);
+ * 
+ *   jobs.ParallelFor(count, 256, [&](std::size_t begin, std::size_t end) { ... });
+ */
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <initializer_list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <cstddef>
+
+namespace Engine::Core {
+    class JobSystem;
+
+    /**
+     * @brief Référence vers une tâche planifiée, utilisée pour l'attendre ou pour en faire une dépendance
+     * 
+     */
+    class JobHandle {
+        friend class JobSystem;
+
+        private:
+            struct Job {
+                std::function<void()> task;
+                /** @brief Dépendances pas encore terminées (+1 tant que la tâche est en cours de planification) */
+                std::atomic<int> dependencies = 1;
+                std::atomic<bool> finished = false;
+                /** @brief Protège dependents et le passage à finished */
+                std::mutex mutex;
+                /** @brief Les tâches qui attendent la fin de celle-ci */
+                std::vector<std::shared_ptr<Job>> dependents;
+                /** @brief Exception levée par la tâche, relancée par JobSystem::Wait */
+                std::exception_ptr error;
+            };
+
+            std::shared_ptr<Job> mJob;
+
+            explicit JobHandle(std::shared_ptr<Job> job) : mJob(std::move(job)) {}
+
+        public:
+            /** @brief Un handle vide, considéré comme déjà terminé */
+            JobHandle() = default;
+
+            /**
+             * @brief Vérifie si la tâche est terminée
+             * 
+             * @return true
+             * @return false
+             */
+            bool IsDone() const { return !mJob || mJob->finished.load(std::memory_order_acquire); }
+    };
+
+    /**
+     * @brief Système de tâches avec vol de tâches (work-stealing), possédé par l'App (voir App::GetJobSystem)
+     * 
+     */
+    class JobSystem {
+        private:
+            using JobPtr = std::shared_ptr<JobHandle::Job>;
+
+            /** @brief File de tâches d'un thread : le propriétaire travaille par la fin, les voleurs par le début */
+            struct WorkQueue {
+                std::mutex mutex;
+                std::deque<JobPtr> jobs;
+            };
+
+            std::vector<std::thread> mWorkers;
+            /** @brief Une file par thread de travail, plus la file partagée des threads extérieurs (index 0) */
+            std::vector<std::unique_ptr<WorkQueue>> mQueues;
+
+            /** @brief Nombre de tâches dans les files, pour endormir les threads quand il n'y a rien à faire */
+            std::atomic<std::size_t> mQueued = 0;
+            std::mutex mSleepMutex;
+            std::condition_variable mWake;
+            bool mStopping = false;
+
+            /**
+             * @brief Renvoie l'index de la file du thread appelant (0 pour un thread extérieur)
+             * 
+             * @return std::size_t
+             */
+            std::size_t QueueIndex() const;
+
+            /**
+             * @brief Ajoute une tâche prête à la file du thread appelant
+             * 
+             * @param job
+             */
+            void Push(JobPtr job);
+
+            /**
+             * @brief Récupère une tâche : d'abord dans la file donnée, puis en volant les autres files
+             * 
+             * @param queueIndex
+             * @return JobPtr (nullptr si toutes les files sont vides)
+             */
+            JobPtr Pop(std::size_t queueIndex);
+
+            /**
+             * @brief Exécute une tâche, puis libère les tâches qui en dépendaient
+             * 
+             * @param job
+             */
+            void Execute(const JobPtr& job);
+
+            /**
+             * @brief Boucle d'un thread de travail
+             * 
+             * @param queueIndex
+             */
+            void WorkerLoop(std::size_t queueIndex);
+
+        public:
+            /**
+             * @brief Démarre les threads de travail
+             * 
+             * @param workerThreads Nombre de threads en plus du thread principal (0 => nombre de coeurs - 1)
+             */
+            explicit JobSystem(unsigned int workerThreads = 0);
+            ~JobSystem();
+            JobSystem(const JobSystem&) = delete;
+            JobSystem& operator=(const JobSystem&) = delete;
+
+            /**
+             * @brief Renvoie le nombre de threads de travail (sans compter le thread principal)
+             * 
+             * @return std::size_t
+             */
+            std::size_t GetWorkerCount() const { return mWorkers.size(); }
+
+            /**
+             * @brief Planifie une tâche, qui démarre dès que toutes ses dépendances sont terminées
+             * 
+             * @param task
+             * @param dependencies
+             * @return JobHandle
+             */
+            JobHandle Schedule(std::function<void()> task, std::initializer_list<JobHandle> dependencies = {});
+
+            /**
+             * @brief Attend la fin d'une tâche, en exécutant d'autres tâches en attendant
+             * 
+             * Relance l'exception levée par la tâche, s'il y en a une.
+             * 
+             * @param handle
+             */
+            void Wait(const JobHandle& handle);
+
+            /**
+             * @brief Découpe l'intervalle [0, count[ en tranches de grain éléments, traitées en parallèle
+             * 
+             * Le thread appelant traite la première tranche puis aide les threads de travail jusqu'à la fin.
+             * Un grain de l'ordre d'un chunk ou d'une page de composants (COMPONENT_PAGE_SIZE) garde chaque tranche contiguë en mémoire.
+             * 
+             * @tparam Func Signature attendue : void(std::size_t begin, std::size_t end)
+             * @param count
+             * @param grain Nombre d'éléments par tranche
+             * @param func
+             */
+            template<typename Func>
+            void ParallelFor(std::size_t count, std::size_t grain, Func&& func) {
+                if(count == 0) return;
+                if(grain == 0) grain = 1;
+
+                if(count <= grain || mWorkers.empty()) {
+                    func(std::size_t(0), count);
+                    return;
+                }
+
+                std::vector<JobHandle> handles;
+                handles.reserve(count / grain + 1);
+                for(std::size_t begin = grain; begin < count; begin += grain) {
+                    std::size_t end = begin + grain < count ? begin + grain : count;
+                    handles.push_back(Schedule([&func, begin, end]() { func(begin, end); }));
+                }
+
+                // Toutes les tranches doivent être terminées avant de relancer une éventuelle exception (func est référencée)
+                std::exception_ptr error;
+                try {
+                    func(std::size_t(0), grain);
+                } catch(...) {
+                    error = std::current_exception();
+                }
+
+                for(const JobHandle& handle : handles) {
+                    try {
+                        Wait(handle);
+                    } catch(...) {
+                        if(!error) error = std::current_exception();
+                    }
+                }
+
+                if(error) std::rethrow_exception(error);
+            }
+    };
+}
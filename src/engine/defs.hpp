@@ -9,8 +9,56 @@
 #include <bitset>
 
 namespace Engine {
-    /** @brief Définition de type pour mieux identifier les EntityID */
+    /**
+     * @brief Définition de type pour mieux identifier les EntityID
+     * 
+     * Un EntityID regroupe deux informations :
+     * - les ENTITY_INDEX_BITS bits de poids faible donnent l'index de l'entité (réutilisé après destruction)
+     * - les bits de poids fort donnent la génération de cet index, incrémentée à chaque destruction
+     * 
+     * Un identifiant conservé après la destruction de son entité ne peut donc pas désigner la nouvelle entité du même index.
+     */
     using EntityID = std::uint32_t;
+    /** @brief Nombre de bits de l'EntityID utilisés pour l'index de l'entité */
+    constexpr std::uint32_t ENTITY_INDEX_BITS = 20;
+    /** @brief Masque de l'index dans un EntityID */
+    constexpr EntityID ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+    /** @brief Masque de la génération (une fois décalée) dans un EntityID */
+    constexpr EntityID ENTITY_GENERATION_MASK = (1u << (32 - ENTITY_INDEX_BITS)) - 1;
+    /** @brief Identifiant qui ne désigne aucune entité */
+    constexpr EntityID NULL_ENTITY = 0xFFFFFFFF;
+
+    /**
+     * @brief Renvoie l'index d'un EntityID (utilisé pour indexer les tableaux de l'ECS)
+     * 
+     * @param entityID 
+     * @return std::uint32_t 
+     */
+    constexpr std::uint32_t EntityIndex(EntityID entityID) { return entityID & ENTITY_INDEX_MASK; }
+    /**
+     * @brief Renvoie la génération d'un EntityID
+     * 
+     * @param entityID 
+     * @return std::uint32_t 
+     */
+    constexpr std::uint32_t EntityGeneration(EntityID entityID) { return entityID >> ENTITY_INDEX_BITS; }
+    /**
+     * @brief Construit un EntityID à partir d'un index et d'une génération
+     * 
+     * @param index 
+     * @param generation 
+     * @return EntityID 
+     */
+    constexpr EntityID MakeEntityID(std::uint32_t index, std::uint32_t generation) {
+        return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+    }
+    /**
+     * @brief Compteur de changements d'un registre (voir Registry::GetChangeTick)
+     * 
+     * Chaque ajout ou modification de composant est daté avec la valeur courante du compteur, qui avance après chaque
+     * exécution de système : un système retrouve ainsi ce qui a changé depuis son dernier passage.
+     */
+    using ChangeTick = std::uint32_t;
     /** @brief Définition d'une enum "Anchor" qui permet de définir le point d'ancrage d'un item (très utile pour les Interfaces Utilisateur) */
     enum class Anchor {
         BottomLeft,
@@ -4,4 +4,10 @@
 #include "ecs/componentstorage.hpp"
 #include "ecs/entity.hpp"
 #include "ecs/registry.hpp"
-#include "ecs/system.hpp"
\ No newline at end of file
+#include "ecs/view.hpp"
+#include "ecs/group.hpp"
+#include "ecs/tag.hpp"
+#include "ecs/commandbuffer.hpp"
+#include "ecs/snapshot.hpp"
+#include "ecs/system.hpp"
+#include "ecs/scheduler.hpp"
\ No newline at end of file
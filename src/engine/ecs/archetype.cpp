@@ -0,0 +1,323 @@
+#include "archetype.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace Engine::ECS {
+    namespace {
+        std::size_t AlignUp(std::size_t offset, std::size_t alignment) {
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    Archetype::Archetype(std::vector<std::size_t> types, std::vector<const ComponentInfo*> infos)
+        : mTypes(std::move(types)), mInfos(std::move(infos)) {
+        std::size_t rowBytes = sizeof(EntityID);
+        for(std::size_t column = 0; column < mTypes.size(); ++column) {
+            if(mInfos[column]->alignment > ARCHETYPE_CHUNK_ALIGNMENT) throw std::runtime_error("Archetype: component alignment is too large for archetype chunks");
+            rowBytes += mInfos[column]->size;
+
+            if(mTypes[column] >= mColumnOf.size()) mColumnOf.resize(mTypes[column] + 1, -1);
+            mColumnOf[mTypes[column]] = static_cast<int>(column);
+        }
+
+        // On cherche la plus grande capacité qui tient dans un chunk, en tenant compte de l'alignement des colonnes
+        mCapacity = static_cast<std::uint32_t>(std::max<std::size_t>(1, ARCHETYPE_CHUNK_SIZE / rowBytes));
+        while(true) {
+            mOffsets.clear();
+            std::size_t offset = mCapacity * sizeof(EntityID);
+
+            for(const ComponentInfo* info : mInfos) {
+                offset = AlignUp(offset, info->alignment);
+                mOffsets.push_back(offset);
+                offset += mCapacity * info->size;
+            }
+
+            if(offset <= ARCHETYPE_CHUNK_SIZE || mCapacity == 1) {
+                mChunkBytes = std::max<std::size_t>(offset, ARCHETYPE_CHUNK_SIZE);
+                break;
+            }
+
+            mCapacity--;
+        }
+    }
+
+    Archetype::~Archetype() {
+        ReleaseChunks();
+    }
+
+    std::size_t Archetype::PushRows(std::size_t count) {
+        std::size_t first = mSize;
+
+        while(count > 0) {
+            if(mChunks.empty() || mChunks.back().count == mCapacity) {
+                auto* data = static_cast<std::byte*>(::operator new(mChunkBytes, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT)));
+                mChunks.push_back({data, 0});
+            }
+
+            std::uint32_t added = static_cast<std::uint32_t>(std::min<std::size_t>(count, mCapacity - mChunks.back().count));
+            mChunks.back().count += added;
+            mSize += added;
+            count -= added;
+        }
+
+        return first;
+    }
+
+    void Archetype::PopRow() {
+        mSize--;
+        if(--mChunks.back().count == 0) {
+            ::operator delete(mChunks.back().data, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT));
+            mChunks.pop_back();
+        }
+    }
+
+    void Archetype::ReleaseChunks() {
+        for(Chunk& chunk : mChunks) {
+            ::operator delete(chunk.data, std::align_val_t(ARCHETYPE_CHUNK_ALIGNMENT));
+        }
+
+        mChunks.clear();
+        mSize = 0;
+    }
+
+    ArchetypeStorage::~ArchetypeStorage() {
+        Clear();
+    }
+
+    void ArchetypeStorage::RegisterType(const ComponentInfo& info) {
+        mInfos[info.typeID] = info;
+    }
+
+    ArchetypeStorage::EntityLocation& ArchetypeStorage::LocationOf(EntityID entityID) {
+        std::uint32_t entityIndex = EntityIndex(entityID);
+        if(entityIndex >= mLocations.size()) mLocations.resize(entityIndex + 1);
+        return mLocations[entityIndex];
+    }
+
+    Archetype* ArchetypeStorage::GetOrCreateArchetype(const std::vector<std::size_t>& types) {
+        auto it = mArchetypeIndex.find(types);
+        if(it != mArchetypeIndex.end()) return it->second;
+
+        std::vector<const ComponentInfo*> infos;
+        for(std::size_t type : types) {
+            auto info = mInfos.find(type);
+            if(info == mInfos.end()) throw std::runtime_error("ArchetypeStorage: component type was not registered");
+            infos.push_back(&info->second);
+        }
+
+        Archetype* archetype = new Archetype(types, std::move(infos));
+        mArchetypeIndex[types] = archetype;
+        mArchetypes.push_back(archetype);
+
+        return archetype;
+    }
+
+    Archetype* ArchetypeStorage::WithType(Archetype* from, std::size_t typeID) {
+        auto edge = from->mAddEdges.find(typeID);
+        if(edge != from->mAddEdges.end()) return edge->second;
+
+        std::vector<std::size_t> types = from->mTypes;
+        types.insert(std::upper_bound(types.begin(), types.end(), typeID), typeID);
+
+        Archetype* to = GetOrCreateArchetype(types);
+        from->mAddEdges[typeID] = to;
+        to->mRemoveEdges[typeID] = from;
+
+        return to;
+    }
+
+    Archetype* ArchetypeStorage::WithoutType(Archetype* from, std::size_t typeID) {
+        auto edge = from->mRemoveEdges.find(typeID);
+        if(edge != from->mRemoveEdges.end()) return edge->second;
+
+        std::vector<std::size_t> types = from->mTypes;
+        types.erase(std::find(types.begin(), types.end(), typeID));
+
+        Archetype* to = GetOrCreateArchetype(types);
+        from->mRemoveEdges[typeID] = to;
+        to->mAddEdges[typeID] = from;
+
+        return to;
+    }
+
+    void ArchetypeStorage::FillHole(Archetype* archetype, std::size_t row) {
+        std::size_t last = archetype->mSize - 1;
+
+        if(row != last) {
+            EntityID moved = archetype->EntityAt(last);
+            archetype->EntityAt(row) = moved;
+
+            for(std::size_t column = 0; column < archetype->mTypes.size(); ++column) {
+                const ComponentInfo* info = archetype->mInfos[column];
+                void* hole = archetype->At(column, row);
+                void* back = archetype->At(column, last);
+
+                if(info->trivial) {
+                    std::memcpy(hole, back, info->size);
+                } else {
+                    info->moveConstruct(hole, back);
+                    info->destroy(back);
+                }
+
+                info->storage->Relocate(&moved, hole, 1);
+            }
+
+            mLocations[EntityIndex(moved)].row = row;
+        }
+
+        archetype->PopRow();
+    }
+
+    std::size_t ArchetypeStorage::MoveEntity(EntityID entityID, Archetype* to) {
+        EntityLocation& location = LocationOf(entityID);
+        Archetype* from = location.archetype;
+
+        std::size_t row = to->PushRows(1);
+        to->EntityAt(row) = entityID;
+
+        if(from) {
+            for(std::size_t column = 0; column < from->mTypes.size(); ++column) {
+                const ComponentInfo* info = from->mInfos[column];
+                void* source = from->At(column, location.row);
+                int target = to->ColumnOf(from->mTypes[column]);
+
+                if(target < 0) {
+                    info->destroy(source);
+                    continue;
+                }
+
+                void* destination = to->At(target, row);
+                if(info->trivial) {
+                    std::memcpy(destination, source, info->size);
+                } else {
+                    info->moveConstruct(destination, source);
+                    info->destroy(source);
+                }
+
+                info->storage->Relocate(&entityID, destination, 1);
+            }
+
+            FillHole(from, location.row);
+        }
+
+        location.archetype = to;
+        location.row = row;
+
+        return row;
+    }
+
+    std::size_t ArchetypeStorage::MoveAll(Archetype* from, Archetype* to) {
+        std::size_t count = from->mSize;
+        std::size_t first = to->PushRows(count);
+
+        // On avance par "runs" de lignes contiguës à la fois dans la source et dans la destination
+        std::size_t done = 0;
+        while(done < count) {
+            std::size_t sourceRow = done;
+            std::size_t targetRow = first + done;
+            std::size_t run = std::min({
+                count - done,
+                static_cast<std::size_t>(from->mCapacity - sourceRow % from->mCapacity),
+                static_cast<std::size_t>(to->mCapacity - targetRow % to->mCapacity)
+            });
+
+            EntityID* entities = &to->EntityAt(targetRow);
+            std::memcpy(entities, &from->EntityAt(sourceRow), run * sizeof(EntityID));
+
+            for(std::size_t column = 0; column < from->mTypes.size(); ++column) {
+                const ComponentInfo* info = from->mInfos[column];
+                auto* source = static_cast<std::byte*>(from->At(column, sourceRow));
+                int target = to->ColumnOf(from->mTypes[column]);
+
+                if(target < 0) {
+                    if(!info->trivial) {
+                        for(std::size_t i = 0; i < run; ++i) info->destroy(source + i * info->size);
+                    }
+                    continue;
+                }
+
+                auto* destination = static_cast<std::byte*>(to->At(target, targetRow));
+                if(info->trivial) {
+                    std::memcpy(destination, source, run * info->size);
+                } else {
+                    for(std::size_t i = 0; i < run; ++i) {
+                        info->moveConstruct(destination + i * info->size, source + i * info->size);
+                        info->destroy(source + i * info->size);
+                    }
+                }
+
+                info->storage->Relocate(entities, destination, run);
+            }
+
+            for(std::size_t i = 0; i < run; ++i) {
+                mLocations[EntityIndex(entities[i])] = {to, targetRow + i};
+            }
+
+            done += run;
+        }
+
+        from->ReleaseChunks();
+
+        return first;
+    }
+
+    void* ArchetypeStorage::Add(EntityID entityID, std::size_t typeID) {
+        EntityLocation& location = LocationOf(entityID);
+        Archetype* to = location.archetype ? WithType(location.archetype, typeID) : GetOrCreateArchetype({typeID});
+
+        std::size_t row = MoveEntity(entityID, to);
+        return to->At(to->ColumnOf(typeID), row);
+    }
+
+    void ArchetypeStorage::Remove(EntityID entityID, std::size_t typeID) {
+        EntityLocation& location = LocationOf(entityID);
+        if(!location.archetype || location.archetype->ColumnOf(typeID) < 0) return;
+
+        MoveEntity(entityID, WithoutType(location.archetype, typeID));
+    }
+
+    void ArchetypeStorage::Destroy(EntityID entityID) {
+        EntityLocation& location = LocationOf(entityID);
+        Archetype* archetype = location.archetype;
+        if(!archetype) return;
+
+        for(std::size_t column = 0; column < archetype->mTypes.size(); ++column) {
+            archetype->mInfos[column]->destroy(archetype->At(column, location.row));
+        }
+
+        FillHole(archetype, location.row);
+        location = {};
+    }
+
+    void ArchetypeStorage::RemoveFromAll(std::size_t typeID) {
+        std::size_t count = mArchetypes.size();
+
+        for(std::size_t i = 0; i < count; ++i) {
+            Archetype* from = mArchetypes[i];
+            if(from->mSize == 0 || from->ColumnOf(typeID) < 0) continue;
+
+            MoveAll(from, WithoutType(from, typeID));
+        }
+    }
+
+    void ArchetypeStorage::Clear() {
+        for(Archetype* archetype : mArchetypes) {
+            for(std::size_t column = 0; column < archetype->mTypes.size(); ++column) {
+                const ComponentInfo* info = archetype->mInfos[column];
+                if(info->trivial) continue;
+
+                for(std::size_t row = 0; row < archetype->mSize; ++row) info->destroy(archetype->At(column, row));
+            }
+
+            delete archetype;
+        }
+
+        mArchetypes.clear();
+        mArchetypeIndex.clear();
+        mLocations.clear();
+        mInfos.clear();
+    }
+}
@@ -0,0 +1,351 @@
+/**
+ * @file archetype.hpp
+ * @brief Stockage optionnel des composants par archétype
+ * 
+ * Un archétype regroupe toutes les entités qui possèdent exactement le même ensemble de composants (compacts).
+ * Les composants d'un archétype sont rangés dans des "chunks" de taille fixe (ARCHETYPE_CHUNK_SIZE), colonne par colonne (SoA) :
+ * 
+ *   | EntityID[capacité] | Transform[capacité] | Rigidbody[capacité] | BoxCollider[capacité] |
+ * 
+ * Parcourir les entités qui ont <Transform, Rigidbody, BoxCollider> revient donc à lire des tableaux contigus.
+ * En contrepartie, ajouter ou retirer un composant déplace l'entité d'un archétype à un autre (changement structurel).
+ * 
+ * Les composants polymorphiques (Behaviour) ne font pas partie des archétypes : ils restent dans leur stockage indirect.
+ */
+#pragma once
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "../defs.hpp"
+#include "../constants.hpp"
+#include "componentstorage.hpp"
+
+namespace Engine::ECS {
+    /**
+     * @brief Mode de stockage des composants d'un registre
+     * 
+     */
+    enum class StorageBackend {
+        /** @brief Un sparse set par type de composant (par défaut) */
+        SparseSet,
+        /** @brief Les composants compacts sont regroupés par archétype, dans des chunks SoA */
+        Archetype
+    };
+
+    /**
+     * @brief Description "type-erased" d'un type de composant, utilisée pour déplacer des composants entre archétypes
+     * 
+     */
+    struct ComponentInfo {
+        /** @brief L'identifiant du type de composant (Registry::GetComponentTypeID) */
+        std::size_t typeID;
+        std::size_t size;
+        std::size_t alignment;
+        /** @brief Vrai si le composant peut être déplacé par un simple memcpy (et détruit sans appel de destructeur) */
+        bool trivial;
+        /** @brief Construit un composant à l'adresse destination en déplaçant le composant source */
+        void (*moveConstruct)(void* destination, void* source);
+        /** @brief Appelle le destructeur du composant */
+        void (*destroy)(void* component);
+        /** @brief Le stockage du type, à prévenir lorsque des composants changent d'adresse */
+        IComponentStorage* storage;
+
+        /**
+         * @brief Construit la description du type T
+         * 
+         * @tparam T
+         * @param typeID
+         * @param storage
+         * @return ComponentInfo
+         */
+        template<typename T>
+        static ComponentInfo Of(std::size_t typeID, IComponentStorage* storage) {
+            return {
+                typeID,
+                sizeof(T),
+                alignof(T),
+                std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                [](void* destination, void* source) { ::new (destination) T(std::move(*static_cast<T*>(source))); },
+                [](void* component) { std::destroy_at(static_cast<T*>(component)); },
+                storage
+            };
+        }
+    };
+
+    /**
+     * @brief Un archétype : l'ensemble des entités qui partagent la même liste de composants
+     * 
+     * Les lignes sont numérotées de manière globale : la ligne r se trouve dans le chunk r / capacité.
+     * Tous les chunks sont pleins, sauf le dernier (une suppression déplace toujours la dernière ligne).
+     */
+    class Archetype {
+        friend class ArchetypeStorage;
+
+        private:
+            struct Chunk {
+                std::byte* data;
+                std::uint32_t count;
+            };
+
+            /** @brief Les identifiants de types de l'archétype, triés */
+            std::vector<std::size_t> mTypes;
+            /** @brief La description de chaque colonne (même ordre que mTypes) */
+            std::vector<const ComponentInfo*> mInfos;
+            /** @brief Position de chaque colonne dans un chunk, en octets */
+            std::vector<std::size_t> mOffsets;
+            /** @brief Associe un identifiant de type à sa colonne (-1 si absent) */
+            std::vector<int> mColumnOf;
+            /** @brief Nombre de lignes par chunk */
+            std::uint32_t mCapacity = 1;
+            /** @brief Taille d'un chunk en octets */
+            std::size_t mChunkBytes = ARCHETYPE_CHUNK_SIZE;
+            std::vector<Chunk> mChunks;
+            /** @brief Nombre total d'entités dans l'archétype */
+            std::size_t mSize = 0;
+
+            /** @brief Archétypes voisins (ajout/retrait d'un type), mis en cache pour les changements structurels */
+            std::unordered_map<std::size_t, Archetype*> mAddEdges;
+            std::unordered_map<std::size_t, Archetype*> mRemoveEdges;
+
+            Archetype(std::vector<std::size_t> types, std::vector<const ComponentInfo*> infos);
+
+            /**
+             * @brief Ajoute des lignes à la fin de l'archétype (non initialisées)
+             * 
+             * @param count
+             * @return std::size_t La première ligne ajoutée
+             */
+            std::size_t PushRows(std::size_t count);
+
+            /**
+             * @brief Retire la dernière ligne (dont les composants doivent déjà avoir été détruits ou déplacés)
+             * 
+             */
+            void PopRow();
+
+            /**
+             * @brief Libère tous les chunks, sans appeler de destructeur
+             * 
+             */
+            void ReleaseChunks();
+
+        public:
+            ~Archetype();
+            Archetype(const Archetype&) = delete;
+            Archetype& operator=(const Archetype&) = delete;
+
+            /**
+             * @brief Renvoie la colonne du type donné, ou -1 si l'archétype ne le contient pas
+             * 
+             * @param typeID
+             * @return int
+             */
+            int ColumnOf(std::size_t typeID) const {
+                return typeID < mColumnOf.size() ? mColumnOf[typeID] : -1;
+            }
+
+            const std::vector<std::size_t>& GetTypes() const { return mTypes; }
+            std::size_t Size() const { return mSize; }
+            std::size_t ChunkCount() const { return mChunks.size(); }
+            std::size_t ChunkSize(std::size_t chunk) const { return mChunks[chunk].count; }
+
+            /**
+             * @brief Renvoie le tableau d'entités d'un chunk
+             * 
+             * @param chunk
+             * @return EntityID*
+             */
+            EntityID* Entities(std::size_t chunk) const {
+                return reinterpret_cast<EntityID*>(mChunks[chunk].data);
+            }
+
+            /**
+             * @brief Renvoie le début d'une colonne dans un chunk
+             * 
+             * @param column
+             * @param chunk
+             * @return void*
+             */
+            void* Column(std::size_t column, std::size_t chunk) const {
+                return mChunks[chunk].data + mOffsets[column];
+            }
+
+            /**
+             * @brief Renvoie l'adresse du composant de la colonne donnée, à la ligne donnée
+             * 
+             * @param column
+             * @param row
+             * @return void*
+             */
+            void* At(std::size_t column, std::size_t row) const {
+                return mChunks[row / mCapacity].data + mOffsets[column] + (row % mCapacity) * mInfos[column]->size;
+            }
+
+            /**
+             * @brief Renvoie l'entité stockée à la ligne donnée
+             * 
+             * @param row
+             * @return EntityID&
+             */
+            EntityID& EntityAt(std::size_t row) const {
+                return Entities(row / mCapacity)[row % mCapacity];
+            }
+    };
+
+    /**
+     * @brief Gère les archétypes d'un registre, et la position de chaque entité dans ces archétypes
+     * 
+     * Le stockage possède les composants compacts : les ComponentStorage de ces types ne sont plus que des index
+     * (voir ComponentStorage::SetExternal), mis à jour à chaque fois qu'un composant change d'adresse.
+     */
+    class ArchetypeStorage {
+        private:
+            /** @brief Position d'une entité dans les archétypes */
+            struct EntityLocation {
+                Archetype* archetype = nullptr;
+                std::size_t row = 0;
+            };
+
+            /** @brief Les types enregistrés, par identifiant de type */
+            std::unordered_map<std::size_t, ComponentInfo> mInfos;
+            /** @brief Retrouve un archétype à partir de sa liste de types */
+            std::map<std::vector<std::size_t>, Archetype*> mArchetypeIndex;
+            /** @brief Tous les archétypes, dans leur ordre de création */
+            std::vector<Archetype*> mArchetypes;
+            /** @brief Position de chaque entité, indexée par EntityIndex */
+            std::vector<EntityLocation> mLocations;
+
+            Archetype* GetOrCreateArchetype(const std::vector<std::size_t>& types);
+            Archetype* WithType(Archetype* from, std::size_t typeID);
+            Archetype* WithoutType(Archetype* from, std::size_t typeID);
+
+            /**
+             * @brief Déplace une entité vers un autre archétype
+             * 
+             * Les composants communs sont déplacés, ceux qui n'existent pas dans l'archétype cible sont détruits.
+             * Les composants propres à l'archétype cible ne sont pas initialisés.
+             * 
+             * @param entityID
+             * @param to
+             * @return std::size_t La ligne de l'entité dans l'archétype cible
+             */
+            std::size_t MoveEntity(EntityID entityID, Archetype* to);
+
+            /**
+             * @brief Comble le trou laissé à une ligne donnée en y déplaçant la dernière ligne de l'archétype
+             * 
+             * @param archetype
+             * @param row
+             */
+            void FillHole(Archetype* archetype, std::size_t row);
+
+            /**
+             * @brief Déplace toutes les entités d'un archétype vers un autre, colonne par colonne
+             * 
+             * @param from
+             * @param to
+             * @return std::size_t La première ligne des entités déplacées dans l'archétype cible
+             */
+            std::size_t MoveAll(Archetype* from, Archetype* to);
+
+            EntityLocation& LocationOf(EntityID entityID);
+
+        public:
+            ArchetypeStorage() = default;
+            ~ArchetypeStorage();
+            ArchetypeStorage(const ArchetypeStorage&) = delete;
+            ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+
+            /**
+             * @brief Enregistre un type de composant compact
+             * 
+             * @param info
+             */
+            void RegisterType(const ComponentInfo& info);
+
+            /**
+             * @brief Ajoute un type à une entité, et renvoie l'emplacement (non initialisé) du nouveau composant
+             * 
+             * @param entityID
+             * @param typeID
+             * @return void*
+             */
+            void* Add(EntityID entityID, std::size_t typeID);
+
+            /**
+             * @brief Détruit le composant du type donné et déplace l'entité dans l'archétype correspondant
+             * 
+             * @param entityID
+             * @param typeID
+             */
+            void Remove(EntityID entityID, std::size_t typeID);
+
+            /**
+             * @brief Détruit tous les composants d'une entité et la retire de son archétype
+             * 
+             * @param entityID
+             */
+            void Destroy(EntityID entityID);
+
+            /**
+             * @brief Détruit tous les composants et tous les archétypes
+             * 
+             */
+            void Clear();
+
+            /**
+             * @brief Retire un type de toutes les entités qui le possèdent, archétype par archétype
+             * 
+             * @param typeID
+             */
+            void RemoveFromAll(std::size_t typeID);
+
+            /**
+             * @brief Ajoute un type à toutes les entités qui possèdent les types donnés (et pas encore celui-ci)
+             * 
+             * Chaque archétype concerné est déplacé en une fois vers son voisin, puis les nouveaux composants sont
+             * construits par la fonction donnée.
+             * 
+             * @tparam Func Signature attendue : void(EntityID, void* emplacement)
+             * @param typeID
+             * @param with
+             * @param construct
+             */
+            template<typename Func>
+            void AddToAll(std::size_t typeID, const std::vector<std::size_t>& with, Func&& construct) {
+                // Les archétypes créés pendant l'opération ne sont pas concernés (ils contiennent déjà typeID)
+                std::size_t count = mArchetypes.size();
+
+                for(std::size_t i = 0; i < count; ++i) {
+                    Archetype* from = mArchetypes[i];
+                    if(from->mSize == 0 || from->ColumnOf(typeID) >= 0) continue;
+
+                    bool matches = true;
+                    for(std::size_t type : with) matches = matches && from->ColumnOf(type) >= 0;
+                    if(!matches) continue;
+
+                    Archetype* to = WithType(from, typeID);
+                    std::size_t moved = from->mSize;
+                    std::size_t first = MoveAll(from, to);
+
+                    int column = to->ColumnOf(typeID);
+                    for(std::size_t row = first; row < first + moved; ++row) {
+                        construct(to->EntityAt(row), to->At(column, row));
+                    }
+                }
+            }
+
+            /**
+             * @brief Renvoie tous les archétypes, dans leur ordre de création
+             * 
+             * @return const std::vector<Archetype*>&
+             */
+            const std::vector<Archetype*>& GetArchetypes() const { return mArchetypes; }
+    };
+}
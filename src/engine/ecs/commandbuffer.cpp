@@ -0,0 +1,45 @@
+#include "commandbuffer.hpp"
+
+namespace Engine::ECS {
+    EntityID CommandBuffer::CreateEntity() {
+        std::lock_guard lock(mMutex);
+        return mRegistry.CreateEntity();
+    }
+
+    void CommandBuffer::DestroyEntity(EntityID entityID) {
+        std::lock_guard lock(mMutex);
+        mCommands.emplace_back([entityID](Registry& registry) { registry.DestroyEntity(entityID); });
+    }
+
+    void CommandBuffer::Clear() {
+        std::lock_guard lock(mMutex);
+        mCommands.clear();
+        mReservations.clear();
+    }
+
+    bool CommandBuffer::Empty() {
+        std::lock_guard lock(mMutex);
+        return mCommands.empty();
+    }
+
+    void CommandBuffer::Flush() {
+        std::vector<std::function<void(Registry&)>> commands;
+        std::unordered_map<std::size_t, Reservation> reservations;
+
+        while(true) {
+            {
+                std::lock_guard lock(mMutex);
+                if(mCommands.empty()) break;
+
+                commands.swap(mCommands);
+                reservations.swap(mReservations);
+            }
+
+            for(auto& [_, reservation] : reservations) reservation.reserve(mRegistry, reservation.count);
+            for(auto& command : commands) command(mRegistry);
+
+            commands.clear();
+            reservations.clear();
+        }
+    }
+}
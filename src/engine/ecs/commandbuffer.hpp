@@ -0,0 +1,133 @@
+/**
+ * @file commandbuffer.hpp
+ * @brief Définit le tampon de commandes ECS : les changements structurels différés jusqu'au prochain point de synchronisation
+ * 
+ * Créer ou détruire une entité, ajouter ou retirer un composant pendant le parcours d'une vue modifie les stockages parcourus.
+ * Les systèmes et les scripts enregistrent plutôt ces opérations dans le tampon de commandes du registre : la classe App
+ * les applique toutes en une fois, entre deux étapes de la boucle (après les fixed updates, l'update et la late update).
+ */
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "../defs.hpp"
+#include "registry.hpp"
+
+namespace Engine::ECS {
+    /**
+     * @brief Liste de changements structurels à appliquer plus tard sur un registre
+     * 
+     * Les commandes sont appliquées dans leur ordre d'enregistrement. L'enregistrement est protégé par un mutex :
+     * plusieurs threads peuvent remplir le même tampon, tant qu'aucun n'accède directement au registre en même temps.
+     */
+    class CommandBuffer {
+        private:
+            /** @brief Fonction qui réserve la place de N composants d'un type dans le registre */
+            using ReserveFunction = void (*)(Registry&, std::size_t);
+
+            /** @brief Nombre de composants en attente pour un type donné, et la fonction qui permet de leur réserver la place */
+            struct Reservation {
+                std::size_t count = 0;
+                ReserveFunction reserve = nullptr;
+            };
+
+            Registry& mRegistry;
+            std::mutex mMutex;
+            /** @brief Les commandes en attente, dans leur ordre d'enregistrement */
+            std::vector<std::function<void(Registry&)>> mCommands;
+            /** @brief Les ajouts de composants en attente, par identifiant de type */
+            std::unordered_map<std::size_t, Reservation> mReservations;
+
+        public:
+            /**
+             * @brief Construit un tampon de commandes vide pour le registre donné
+             * 
+             * @param registry
+             */
+            explicit CommandBuffer(Registry& registry) : mRegistry(registry) {}
+            CommandBuffer(const CommandBuffer&) = delete;
+            CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+            /**
+             * @brief Réserve un nouvel identifiant d'entité, utilisable tout de suite dans les commandes suivantes
+             * 
+             * L'entité existe dès l'appel, mais sans aucun composant : elle n'apparaît dans aucune vue avant le prochain Flush.
+             * 
+             * @return EntityID
+             */
+            EntityID CreateEntity();
+
+            /**
+             * @brief Enregistre la destruction d'une entité
+             * 
+             * @param entityID
+             */
+            void DestroyEntity(EntityID entityID);
+
+            /**
+             * @brief Enregistre l'ajout d'un composant, construit tout de suite à partir des arguments donnés
+             * 
+             * Le composant est ignoré si l'entité n'est plus valide au moment du Flush.
+             * 
+             * @tparam T Le type de component à ajouter
+             * @tparam Args
+             * @param entityID
+             * @param args Les arguments pour créer le composant
+             */
+            template<typename T, typename... Args>
+            void AddComponent(EntityID entityID, Args&&... args) {
+                using Base = typename BaseOrSelf<T>::type;
+
+                auto component = std::make_shared<T>(std::forward<Args>(args)...);
+                std::size_t tid = mRegistry.GetComponentTypeID<Base>();
+
+                std::lock_guard lock(mMutex);
+                Reservation& reservation = mReservations[tid];
+                reservation.count++;
+                reservation.reserve = [](Registry& registry, std::size_t count) { registry.Reserve<Base>(count); };
+
+                mCommands.emplace_back([entityID, component](Registry& registry) {
+                    if(registry.IsValidEntity(entityID)) registry.AddComponent<T>(entityID, std::move(*component));
+                });
+            }
+
+            /**
+             * @brief Enregistre la suppression du composant de type T d'une entité
+             * 
+             * @tparam T Le type de component à supprimer
+             * @param entityID
+             */
+            template<typename T>
+            void RemoveComponent(EntityID entityID) {
+                std::lock_guard lock(mMutex);
+                mCommands.emplace_back([entityID](Registry& registry) { registry.RemoveComponent<T>(entityID); });
+            }
+
+            /**
+             * @brief Abandonne toutes les commandes en attente
+             * 
+             */
+            void Clear();
+
+            /**
+             * @brief Vérifie si des commandes sont en attente
+             * 
+             * @return true
+             * @return false
+             */
+            bool Empty();
+
+            /**
+             * @brief Applique toutes les commandes en attente, dans leur ordre d'enregistrement
+             * 
+             * La place des composants ajoutés est réservée en une fois, type par type, avant d'appliquer les commandes.
+             * Les commandes enregistrées pendant le Flush sont appliquées dans la foulée.
+             */
+            void Flush();
+    };
+}
@@ -13,14 +13,31 @@ namespace Engine::ECS {
      * @brief Classe Component à dériver pour pouvoir être utilisée dans les systèmes ECS
      * 
      * Son intérêt réside dans le fait qu'elle peut stocker une entité et la renvoyer.
-     * Dans le cadre de l'ECS, c'est le registre qui créé les components, et au passage, il appelle le setter pour lui attacher l'entité
+     * Dans le cadre de l'ECS, c'est le registre qui créé les components, et au passage, il leur attache l'entité.
+     * L'entité est gardée directement dans le composant (identifiant + registre) : aucune allocation, et elle suit
+     * le composant quand celui-ci est déplacé dans son stockage.
      */
     class Component {
         friend class Registry;
+        friend class Snapshot;
 
         private:
-            /** @brief L'entité attachée à ce component */
-            Entity* mEntity;
+            /** @brief L'identifiant de l'entité attachée à ce component */
+            EntityID mEntityID = NULL_ENTITY;
+            /** @brief Le registre qui possède l'entité */
+            Registry* mRegistry = nullptr;
+
+            /**
+             * @brief Attache l'entité au component (appelé par le registre à chaque ajout de composant)
+             * 
+             * @param entityID 
+             * @param registry 
+             */
+            void SetOwner(EntityID entityID, Registry* registry) {
+                mEntityID = entityID;
+                mRegistry = registry;
+            }
+
         public:
             Component() = default;
             bool enabled = true;
@@ -30,7 +47,7 @@ namespace Engine::ECS {
              * 
              * @param e 
              */
-            void SetEntity(Entity e) { mEntity = new Entity(e); }
+            void SetEntity(Entity e) { SetOwner(e.GetID(), &e.GetRegistry()); }
             /**
              * @brief Renvoie l'entité attachée
              * 
@@ -39,14 +56,21 @@ namespace Engine::ECS {
              * 
              * @return Entity 
              */
-            Entity& GetEntity() const { return *mEntity; }
+            Entity GetEntity() const { return Entity(mEntityID, mRegistry); }
+
+            /**
+             * @brief Renvoie l'identifiant de l'entité attachée
+             * 
+             * @return EntityID 
+             */
+            EntityID GetEntityID() const { return mEntityID; }
 
             /**
              * @brief Renvoie le registre actuel
              * 
              * @return Registry& 
              */
-            Registry& GetRegistry() const { return mEntity->GetRegistry(); }
+            Registry& GetRegistry() const { return *mRegistry; }
 
             /**
              * @brief Renvoie la scène en cours
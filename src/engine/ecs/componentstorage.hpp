@@ -1,15 +1,65 @@
 /**
  * @file componentstorage.hpp
- * @brief 
+ * @brief Stockage des composants de l'ECS, sous forme de "sparse set"
+ * 
+ * Chaque stockage garde trois tableaux :
+ * - un index "sparse", indexé par EntityID, qui donne la position de l'entité dans les tableaux denses
+ * - un tableau dense d'EntityIDs
+ * - un tableau dense de composants, rangés dans le même ordre que les entités
+ * 
+ * Les tableaux denses ne contiennent jamais de trous : une suppression déplace le dernier élément à la place
+ * de l'élément supprimé (swap-and-pop). Parcourir un stockage revient donc à parcourir de la mémoire contiguë.
  */
 #pragma once
 
 #include <unordered_map>
 #include <vector>
+#include <memory>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <typeindex>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <cstring>
+#include <cstddef>
 
 #include "../defs.hpp"
+#include "../constants.hpp"
+#include "poolallocator.hpp"
 
 namespace Engine::ECS {
+    // Templates qui permettent de checker si un composant possède un ::BaseType
+    template<typename, typename = std::void_t<>>
+    struct HasBaseType : std::false_type {};
+
+    template<typename T>
+    struct HasBaseType<T, std::void_t<typename T::BaseType>> : std::true_type {};
+    
+    template<typename T, bool = HasBaseType<T>::value>
+    struct BaseOrSelf {
+        using type = T;
+    };
+
+    template<typename T>
+    struct BaseOrSelf<T, true> {
+        using type = typename T::BaseType;
+    };
+
+    /** @brief Le type sous lequel un composant T est rangé dans les stockages (son BaseType s'il en a un) */
+    template<typename T>
+    using StorageType = typename BaseOrSelf<std::remove_const_t<T>>::type;
+
+    /** @brief Un évènement d'ajout, de modification ou de suppression de composant, daté par le compteur de changements */
+    struct ComponentEvent {
+        EntityID entityID;
+        ChangeTick tick;
+    };
+
+    /** @brief Identifiant d'un observateur de stockage, pour pouvoir le retirer (voir Registry::OnAdd) */
+    using ObserverID = std::uint32_t;
+
     /**
      * @brief Interface pour le système de stockage de composants
      * 
@@ -27,93 +77,850 @@ namespace Engine::ECS {
          * 
          */
         virtual void Clear() = 0;
-        
+
+        /**
+         * @brief Retire le composant de toutes les entités du stockage
+         * 
+         * Comme Remove : les composants indirects ne sont détruits qu'au prochain ReleaseRemoved, et les pools sont gardés.
+         */
+        virtual void RemoveAll() = 0;
+
+        /**
+         * @brief Renvoie le nombre d'entités présentes dans le stockage
+         * 
+         * @return std::size_t
+         */
+        virtual std::size_t Size() const = 0;
+
+        /**
+         * @brief Prévient le stockage que des composants ont changé d'adresse (stockage externe uniquement)
+         * 
+         * @param entities Les entités dont les composants ont été déplacés
+         * @param first L'adresse du composant de la première entité, les suivants sont contigus
+         * @param count Le nombre d'entités concernées
+         */
+        virtual void Relocate(const EntityID* entities, void* first, std::size_t count) = 0;
+
+        /**
+         * @brief Détruit les composants retirés depuis le dernier appel (stockage indirect uniquement)
+         * 
+         * Appelé par le registre à chaque point de synchronisation : un script peut ainsi détruire sa propre entité
+         * pendant l'un de ses callbacks sans être libéré avant la fin de l'appel.
+         */
+        virtual void ReleaseRemoved() = 0;
+
+        /**
+         * @brief Oublie les évènements d'ajout, de modification et de suppression datés de upTo ou avant
+         * 
+         * @param upTo
+         */
+        virtual void TrimEvents(ChangeTick upTo) = 0;
+
+        /**
+         * @brief Appelle les observateurs différés pour les ajouts et suppressions survenus depuis le dernier appel
+         * 
+         * Appelé par le registre à chaque point de synchronisation (voir Registry::FlushCommands).
+         */
+        virtual void DispatchDeferred() = 0;
+
         virtual ~IComponentStorage() = default;
     };
 
     /**
      * @brief Stockage de composant typé selon template, basé sur l'interface générique
      * 
+     * Deux modes de stockage sont possibles, choisis à la compilation selon le type T :
+     * - Mode "compact" (types non polymorphiques) : les composants sont stockés par valeur, dans des pages contiguës.
+     *   Une entité ne peut posséder qu'un seul composant de ce type.
+     * - Mode "indirect" (types polymorphiques, comme Behaviour) : le stockage garde des pointeurs vers les composants,
+     *   ce qui permet de stocker des types dérivés et plusieurs composants du même type sur une même entité.
+     * 
+     * En mode compact, le stockage peut aussi être "externe" (backend StorageBackend::Archetype) : les composants
+     * appartiennent alors aux chunks d'archétypes, et le stockage ne garde que leurs adresses.
+     * 
+     * Attention : supprimer un composant déplace le dernier composant du stockage (swap-and-pop),
+     * une référence obtenue avant une suppression peut donc pointer vers les données d'une autre entité.
+     * 
      * @tparam T Type de composant que le stockage utilise
      */
     template<typename T>
     class ComponentStorage : public IComponentStorage {
+        public:
+            /** @brief Vrai si les composants sont stockés par valeur dans des pages contiguës */
+            static constexpr bool IsPacked = !std::is_polymorphic_v<T>;
+
         private:
-            /** @brief Stockage de composants de type T, indexés selon l'identifiant de l'entité qui les possède */
-            std::unordered_map<EntityID, std::vector<T*>> mComponents;
-        
+            /** @brief Valeur de l'index sparse pour une entité absente du stockage */
+            static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+            /** @brief Index sparse : associe l'index d'une entité (EntityIndex) à sa position dans les tableaux denses */
+            std::vector<std::uint32_t> mSparse;
+            /** @brief Tableau dense des entités présentes dans le stockage */
+            std::vector<EntityID> mEntities;
+            /** @brief Pages de COMPONENT_PAGE_SIZE composants (mode compact) */
+            std::vector<T*> mPages;
+            /** @brief Listes de composants par entité, dans l'ordre du tableau dense (mode indirect) */
+            std::vector<std::vector<T*>> mLists;
+            /** @brief Vrai si les composants appartiennent aux archétypes du registre */
+            bool mExternal = false;
+            /** @brief Adresses des composants, dans l'ordre du tableau dense (mode externe) */
+            std::vector<T*> mAddresses;
+            /** @brief Un pool par type concret de composant (mode indirect) */
+            std::unordered_map<std::type_index, std::unique_ptr<PoolAllocator>> mPools;
+            /** @brief Composants retirés, en attente de destruction (mode indirect, voir ReleaseRemoved) */
+            std::vector<T*> mRemoved;
+
+            /* Suivi des changements */
+            /** @brief Le compteur de changements du registre (nullptr => tous les changements sont datés de 0) */
+            const std::atomic<ChangeTick>* mTickSource = nullptr;
+            /** @brief Date d'ajout de chaque composant, dans l'ordre du tableau dense */
+            std::vector<ChangeTick> mAddedTicks;
+            /** @brief Date de dernière modification de chaque composant (ajout compris), dans l'ordre du tableau dense */
+            std::vector<ChangeTick> mChangedTicks;
+            /** @brief Flux d'évènements, dans l'ordre chronologique (voir TrimEvents) */
+            std::vector<ComponentEvent> mAddedEvents;
+            std::vector<ComponentEvent> mChangedEvents;
+            std::vector<ComponentEvent> mRemovedEvents;
+
+            /* Observateurs */
+            /** @brief Un observateur appelé immédiatement, avec le composant encore valide */
+            struct ImmediateObserver {
+                ObserverID id;
+                std::function<void(EntityID, T&)> callback;
+            };
+            /** @brief Un observateur appelé au prochain point de synchronisation, avec l'entité seulement */
+            struct DeferredObserver {
+                ObserverID id;
+                std::function<void(EntityID)> callback;
+            };
+            ObserverID mNextObserverID = 0;
+            std::vector<ImmediateObserver> mOnAdd;
+            std::vector<ImmediateObserver> mOnRemove;
+            std::vector<DeferredObserver> mOnAddDeferred;
+            std::vector<DeferredObserver> mOnRemoveDeferred;
+            /** @brief Position, dans les flux d'évènements, des premiers ajouts/suppressions pas encore transmis aux observateurs différés */
+            std::size_t mAddedCursor = 0;
+            std::size_t mRemovedCursor = 0;
+
+            /**
+             * @brief Appelle les observateurs immédiats de suppression pour tous les composants de l'entité
+             * 
+             * @param entityID
+             */
+            void NotifyRemoving(EntityID entityID) {
+                if(mOnRemove.empty()) return;
+
+                if constexpr (IsPacked) {
+                    T& component = *Slot(mSparse[EntityIndex(entityID)]);
+                    for(auto& observer : mOnRemove) observer.callback(entityID, component);
+                } else {
+                    for(T* component : mLists[mSparse[EntityIndex(entityID)]]) {
+                        for(auto& observer : mOnRemove) observer.callback(entityID, *component);
+                    }
+                }
+            }
+
+            /**
+             * @brief Renvoie la valeur courante du compteur de changements
+             * 
+             * @return ChangeTick
+             */
+            ChangeTick CurrentTick() const {
+                return mTickSource ? mTickSource->load(std::memory_order_relaxed) : 0;
+            }
+
+            /**
+             * @brief Renvoie l'index du premier évènement postérieur à since (les flux sont triés par date)
+             * 
+             * @param events
+             * @param since
+             * @return std::size_t
+             */
+            static std::size_t FirstEventAfter(const std::vector<ComponentEvent>& events, ChangeTick since) {
+                auto it = std::upper_bound(events.begin(), events.end(), since, [](ChangeTick tick, const ComponentEvent& event) { return tick < event.tick; });
+                return static_cast<std::size_t>(it - events.begin());
+            }
+
+            /**
+             * @brief Renvoie l'adresse du composant à la position dense donnée (mode compact)
+             * 
+             * @param index
+             * @return T*
+             */
+            T* Slot(std::size_t index) const {
+                if(mExternal) return mAddresses[index];
+                return mPages[index / COMPONENT_PAGE_SIZE] + (index % COMPONENT_PAGE_SIZE);
+            }
+
+            /**
+             * @brief Réserve une nouvelle position dense pour l'entité donnée
+             * 
+             * @param entityID
+             * @return std::size_t La position dense attribuée
+             */
+            std::size_t Insert(EntityID entityID) {
+                if(EntityIndex(entityID) >= mSparse.size()) mSparse.resize(EntityIndex(entityID) + 1, INVALID_INDEX);
+
+                std::size_t index = mEntities.size();
+                mSparse[EntityIndex(entityID)] = static_cast<std::uint32_t>(index);
+                mEntities.push_back(entityID);
+
+                ChangeTick tick = CurrentTick();
+                mAddedTicks.push_back(tick);
+                mChangedTicks.push_back(tick);
+                mAddedEvents.push_back({entityID, tick});
+                mChangedEvents.push_back({entityID, tick});
+
+                return index;
+            }
+
+            /**
+             * @brief Ajoute un composant au stockage, associé à l'entityID donné (mode indirect)
+             * 
+             * @param entityID
+             * @param component Un composant alloué par l'un des pools du stockage
+             */
+            void Add(EntityID entityID, T* component) requires (!IsPacked) {
+                if(!Contains(entityID)) {
+                    Insert(entityID);
+                    mLists.emplace_back();
+                }
+
+                mLists[mSparse[EntityIndex(entityID)]].push_back(component);
+            }
+
+            /**
+             * @brief Détruit un composant et rend sa mémoire au pool de son type concret (mode indirect)
+             * 
+             * @param component
+             */
+            void Destroy(T* component) requires (!IsPacked) {
+                PoolAllocator& pool = *mPools.at(std::type_index(typeid(*component)));
+                void* slot = dynamic_cast<void*>(component); // Adresse de l'objet complet, celle renvoyée par le pool
+
+                std::destroy_at(component);
+                pool.Deallocate(slot);
+            }
+
         public:
+            ComponentStorage() = default;
+            ComponentStorage(const ComponentStorage&) = delete;
+            ComponentStorage& operator=(const ComponentStorage&) = delete;
+            ~ComponentStorage() override { Clear(); }
+
             /**
-             * @brief Ajoute un nouveau composant au stockage, associé à l'entityID donné
+             * @brief Passe le stockage en mode externe : les composants sont construits et possédés par les archétypes
              * 
-             * @param entityID 
-             * @param component 
              */
-            void Add(EntityID entityID, T* component) {
-                mComponents[entityID].push_back(component);
+            void SetExternal() requires IsPacked {
+                if(!mEntities.empty()) throw std::runtime_error("ComponentStorage::SetExternal: the storage must be empty");
+                mExternal = true;
+            }
+
+            /**
+             * @brief Vérifie si les composants du stockage appartiennent aux archétypes du registre
+             * 
+             * @return true 
+             * @return false 
+             */
+            bool IsExternal() const {
+                return mExternal;
+            }
+
+            /**
+             * @brief Vérifie si l'entité possède au moins un composant dans ce stockage
+             * 
+             * L'EntityID complet est comparé : un identifiant périmé (génération précédente) n'est jamais reconnu.
+             * 
+             * @param entityID
+             * @return true
+             * @return false
+             */
+            bool Contains(EntityID entityID) const {
+                std::uint32_t entityIndex = EntityIndex(entityID);
+                return entityIndex < mSparse.size() && mSparse[entityIndex] != INVALID_INDEX && mEntities[mSparse[entityIndex]] == entityID;
+            }
+
+            /**
+             * @brief Renvoie la position dense de l'entité (à n'utiliser que si Contains(entityID) est vrai)
+             * 
+             * @param entityID
+             * @return std::size_t
+             */
+            std::size_t IndexOf(EntityID entityID) const {
+                return mSparse[EntityIndex(entityID)];
+            }
+
+            /**
+             * @brief Renvoie le nombre d'entités présentes dans le stockage
+             * 
+             * @return std::size_t
+             */
+            std::size_t Size() const override {
+                return mEntities.size();
+            }
+
+            /**
+             * @brief Renvoie le tableau dense des entités du stockage (même ordre que les composants)
+             * 
+             * @return const std::vector<EntityID>&
+             */
+            const std::vector<EntityID>& GetEntities() const {
+                return mEntities;
+            }
+
+            /**
+             * @brief Renvoie le composant stocké à la position dense donnée
+             * 
+             * Permet de parcourir le stockage de manière linéaire, sans passer par l'index sparse.
+             * En mode indirect, renvoie le premier composant de l'entité.
+             * 
+             * @param index Position dense (entre 0 et Size())
+             * @return T&
+             */
+            T& GetAt(std::size_t index) {
+                if constexpr (IsPacked) return *Slot(index);
+                else return *mLists[index].front();
+            }
+
+            /**
+             * @brief Réserve la mémoire nécessaire pour stocker le nombre de composants donné, sans rien construire
+             * 
+             * En mode compact, les pages manquantes sont allouées d'avance.
+             * 
+             * @param capacity
+             */
+            void Reserve(std::size_t capacity) {
+                mEntities.reserve(capacity);
+                mAddedTicks.reserve(capacity);
+                mChangedTicks.reserve(capacity);
+
+                if(mExternal) {
+                    mAddresses.reserve(capacity);
+                } else if constexpr (IsPacked) {
+                    while(mPages.size() * COMPONENT_PAGE_SIZE < capacity) {
+                        mPages.push_back(std::allocator<T>().allocate(COMPONENT_PAGE_SIZE));
+                    }
+                } else {
+                    mLists.reserve(capacity);
+                }
+            }
+
+            /**
+             * @brief Construit un nouveau composant directement dans le stockage (mode compact)
+             * 
+             * @tparam Args
+             * @param entityID L'entité qui possède le composant
+             * @param args Les arguments de construction du composant
+             * @return T& Une référence vers le composant construit
+             */
+            template<typename... Args>
+            T& Emplace(EntityID entityID, Args&&... args) requires IsPacked {
+                if(Contains(entityID)) throw std::runtime_error("ComponentStorage::Emplace: this entity already has such a component");
+                if(mExternal) throw std::runtime_error("ComponentStorage::Emplace: components of an external storage are constructed by the archetypes");
+
+                std::size_t index = mEntities.size();
+                if(index / COMPONENT_PAGE_SIZE >= mPages.size()) {
+                    mPages.push_back(std::allocator<T>().allocate(COMPONENT_PAGE_SIZE));
+                }
+
+                T* slot = ::new (static_cast<void*>(Slot(index))) T(std::forward<Args>(args)...);
+                Insert(entityID);
+
+                return *slot;
+            }
+
+            /**
+             * @brief Copie octet par octet tous les composants, dans l'ordre du tableau dense (mode compact, types trivialement copiables)
+             * 
+             * En mode compact, chaque page est copiée d'un bloc. En mode externe, les composants sont copiés un par un.
+             * 
+             * @param out Doit pouvoir contenir Size() * sizeof(T) octets
+             */
+            void CopyTo(std::byte* out) const requires IsPacked {
+                static_assert(std::is_trivially_copyable_v<T>, "ComponentStorage::CopyTo: T must be trivially copyable");
+
+                if(mExternal) {
+                    for(std::size_t i = 0; i < mAddresses.size(); ++i) std::memcpy(out + i * sizeof(T), mAddresses[i], sizeof(T));
+                    return;
+                }
+
+                for(std::size_t first = 0; first < mEntities.size(); first += COMPONENT_PAGE_SIZE) {
+                    std::size_t count = std::min(COMPONENT_PAGE_SIZE, mEntities.size() - first);
+                    std::memcpy(out + first * sizeof(T), mPages[first / COMPONENT_PAGE_SIZE], count * sizeof(T));
+                }
+            }
+
+            /**
+             * @brief Ajoute des composants copiés octet par octet, page par page (mode compact non externe, types trivialement copiables)
+             * 
+             * @param entities Les entités qui reçoivent les composants (aucune ne doit déjà en posséder un)
+             * @param data Les composants, dans le même ordre que les entités
+             * @param count 
+             */
+            void AppendRaw(const EntityID* entities, const std::byte* data, std::size_t count) requires IsPacked {
+                static_assert(std::is_trivially_copyable_v<T>, "ComponentStorage::AppendRaw: T must be trivially copyable");
+                if(mExternal) throw std::runtime_error("ComponentStorage::AppendRaw: components of an external storage are constructed by the archetypes");
+                for(std::size_t i = 0; i < count; ++i) {
+                    if(Contains(entities[i])) throw std::runtime_error("ComponentStorage::AppendRaw: this entity already has such a component");
+                }
+
+                Reserve(mEntities.size() + count);
+
+                std::size_t first = mEntities.size();
+                for(std::size_t copied = 0; copied < count;) {
+                    std::size_t index = first + copied;
+                    std::size_t chunk = std::min(COMPONENT_PAGE_SIZE - index % COMPONENT_PAGE_SIZE, count - copied);
+                    std::memcpy(static_cast<void*>(Slot(index)), data + copied * sizeof(T), chunk * sizeof(T));
+                    copied += chunk;
+                }
+
+                for(std::size_t i = 0; i < count; ++i) Insert(entities[i]);
+            }
+
+            /**
+             * @brief Référence un composant construit en dehors du stockage (mode externe)
+             * 
+             * @param entityID
+             * @param component L'adresse du composant, dans un chunk d'archétype
+             */
+            void Attach(EntityID entityID, T* component) requires IsPacked {
+                if(Contains(entityID)) throw std::runtime_error("ComponentStorage::Attach: this entity already has such a component");
+
+                Insert(entityID);
+                mAddresses.push_back(component);
+            }
+
+            /**
+             * @brief Met à jour les adresses des composants déplacés par les archétypes (mode externe)
+             * 
+             * @param entities
+             * @param first
+             * @param count
+             */
+            void Relocate(const EntityID* entities, void* first, std::size_t count) override {
+                if constexpr (IsPacked) {
+                    T* component = static_cast<T*>(first);
+                    for(std::size_t i = 0; i < count; ++i) mAddresses[mSparse[EntityIndex(entities[i])]] = component + i;
+                }
+            }
+
+            /**
+             * @brief Construit un nouveau composant de type concret U dans le pool de ce type, et l'ajoute à l'entité (mode indirect)
+             * 
+             * @tparam U Le type concret du composant (T ou un type dérivé)
+             * @tparam Args
+             * @param entityID L'entité qui possède le composant
+             * @param args Les arguments de construction du composant
+             * @return U& Une référence vers le composant construit
+             */
+            template<typename U, typename... Args>
+            U& Create(EntityID entityID, Args&&... args) requires (!IsPacked) {
+                static_assert(std::is_base_of_v<T, U>, "ComponentStorage::Create: U must derive from the storage type");
+
+                auto& pool = mPools[std::type_index(typeid(U))];
+                if(!pool) pool = std::make_unique<PoolAllocator>(sizeof(U), alignof(U));
+
+                void* slot = pool->Allocate();
+                U* component = nullptr;
+                try {
+                    component = ::new (slot) U(std::forward<Args>(args)...);
+                } catch(...) {
+                    pool->Deallocate(slot);
+                    throw;
+                }
+
+                Add(entityID, component);
+                return *component;
+            }
+
+            /**
+             * @brief Détruit les composants retirés depuis le dernier appel (mode indirect)
+             * 
+             */
+            void ReleaseRemoved() override {
+                if constexpr (!IsPacked) {
+                    for(T* component : mRemoved) Destroy(component);
+                    mRemoved.clear();
+                }
             }
 
             /**
              * @brief Supprime le composant associé à l'entityID donné
              * 
-             * @param entityID 
+             * Le dernier élément des tableaux denses prend la place de l'élément supprimé.
+             * En mode externe, le composant n'est pas détruit : c'est à l'archétype de le faire.
+             * 
+             * @param entityID
              */
             void Remove(EntityID entityID) override {
-                mComponents.erase(entityID);
+                if(!Contains(entityID)) return;
+
+                // Les observateurs voient le composant avant sa suppression
+                NotifyRemoving(entityID);
+
+                std::size_t index = mSparse[EntityIndex(entityID)];
+                std::size_t last = mEntities.size() - 1;
+
+                if(mExternal) {
+                    mAddresses[index] = mAddresses[last];
+                    mAddresses.pop_back();
+                } else if constexpr (IsPacked) {
+                    T* hole = Slot(index);
+                    std::destroy_at(hole);
+
+                    if(index != last) {
+                        T* back = Slot(last);
+                        ::new (static_cast<void*>(hole)) T(std::move(*back));
+                        std::destroy_at(back);
+                    }
+                } else {
+                    // Les composants ne sont détruits qu'au prochain ReleaseRemoved
+                    mRemoved.insert(mRemoved.end(), mLists[index].begin(), mLists[index].end());
+
+                    if(index != last) mLists[index] = std::move(mLists[last]);
+                    mLists.pop_back();
+                }
+
+                if(index != last) {
+                    mEntities[index] = mEntities[last];
+                    mAddedTicks[index] = mAddedTicks[last];
+                    mChangedTicks[index] = mChangedTicks[last];
+                    mSparse[EntityIndex(mEntities[index])] = static_cast<std::uint32_t>(index);
+                }
+
+                mEntities.pop_back();
+                mAddedTicks.pop_back();
+                mChangedTicks.pop_back();
+                mSparse[EntityIndex(entityID)] = INVALID_INDEX;
+                mRemovedEvents.push_back({entityID, CurrentTick()});
+            }
+
+            /**
+             * @brief Retire le composant de toutes les entités du stockage
+             * 
+             * Contrairement à Clear, les composants indirects (scripts) sont gardés jusqu'au prochain ReleaseRemoved :
+             * un script peut retirer tous les composants de son type pendant l'un de ses callbacks.
+             */
+            void RemoveAll() override {
+                if constexpr (!IsPacked) {
+                    if(!mExternal) {
+                        ChangeTick tick = CurrentTick();
+                        for(EntityID entityID : mEntities) {
+                            mRemovedEvents.push_back({entityID, tick});
+                            mSparse[EntityIndex(entityID)] = INVALID_INDEX;
+                        }
+                        for(auto& list : mLists) mRemoved.insert(mRemoved.end(), list.begin(), list.end());
+
+                        mLists.clear();
+                        mEntities.clear();
+                        mAddedTicks.clear();
+                        mChangedTicks.clear();
+                        return;
+                    }
+                }
+
+                Clear();
             }
 
             /**
              * @brief Nettoye le stockage de composants
              * 
+             * En mode externe, seuls les index sont vidés : les composants appartiennent aux archétypes.
+             * Chaque composant retiré produit un évènement de suppression.
              */
             void Clear() override {
-                for(auto [_, list] : mComponents) { 
-                    for(auto t : list) delete t; 
+                ChangeTick tick = CurrentTick();
+                for(EntityID entityID : mEntities) mRemovedEvents.push_back({entityID, tick});
+
+                if(mExternal) {
+                    mAddresses.clear();
+                } else if constexpr (IsPacked) {
+                    for(std::size_t i = 0; i < mEntities.size(); ++i) std::destroy_at(Slot(i));
+                    for(T* page : mPages) std::allocator<T>().deallocate(page, COMPONENT_PAGE_SIZE);
+                    mPages.clear();
+                } else {
+                    // Les destructeurs sont appelés un par un, mais la mémoire est rendue en une fois, bloc par bloc
+                    for(auto& list : mLists) {
+                        for(T* component : list) std::destroy_at(component);
+                    }
+                    for(T* component : mRemoved) std::destroy_at(component);
+
+                    mLists.clear();
+                    mRemoved.clear();
+                    mPools.clear();
+                }
+
+                mEntities.clear();
+                mAddedTicks.clear();
+                mChangedTicks.clear();
+                mSparse.clear();
+            }
+
+            /**
+             * @brief Branche le stockage sur le compteur de changements de son registre
+             * 
+             * @param tickSource
+             */
+            void SetTickSource(const std::atomic<ChangeTick>* tickSource) {
+                mTickSource = tickSource;
+            }
+
+            /**
+             * @brief Signale que le composant de l'entité a été modifié (sans effet si elle n'en possède pas)
+             * 
+             * @param entityID
+             */
+            void MarkChanged(EntityID entityID) {
+                if(!Contains(entityID)) return;
+
+                ChangeTick tick = CurrentTick();
+                ChangeTick& changed = mChangedTicks[mSparse[EntityIndex(entityID)]];
+
+                // Une seule entrée dans le flux par composant et par valeur du compteur
+                if(changed != tick) {
+                    changed = tick;
+                    mChangedEvents.push_back({entityID, tick});
+                }
+            }
+
+            /**
+             * @brief Renvoie la date d'ajout du composant de l'entité (à n'utiliser que si Contains(entityID) est vrai)
+             * 
+             * @param entityID
+             * @return ChangeTick
+             */
+            ChangeTick GetAddedTick(EntityID entityID) const {
+                return mAddedTicks[mSparse[EntityIndex(entityID)]];
+            }
+
+            /**
+             * @brief Renvoie la date de dernière modification du composant de l'entité (à n'utiliser que si Contains(entityID) est vrai)
+             * 
+             * @param entityID
+             * @return ChangeTick
+             */
+            ChangeTick GetChangedTick(EntityID entityID) const {
+                return mChangedTicks[mSparse[EntityIndex(entityID)]];
+            }
+
+            /**
+             * @brief Appelle func(entityID) pour chaque entité dont le composant a été ajouté après since, et qui le possède encore
+             * 
+             * @tparam Func
+             * @param since
+             * @param func
+             */
+            template<typename Func>
+            void ForEachAdded(ChangeTick since, Func&& func) const {
+                for(std::size_t i = FirstEventAfter(mAddedEvents, since); i < mAddedEvents.size(); ++i) {
+                    const ComponentEvent& event = mAddedEvents[i];
+                    if(Contains(event.entityID) && GetAddedTick(event.entityID) == event.tick) func(event.entityID);
+                }
+            }
+
+            /**
+             * @brief Appelle func(entityID) une fois pour chaque entité dont le composant a été ajouté ou modifié après since
+             * 
+             * Seule la dernière modification de chaque composant est retenue (les évènements plus anciens sont ignorés).
+             * 
+             * @tparam Func
+             * @param since
+             * @param func
+             */
+            template<typename Func>
+            void ForEachChanged(ChangeTick since, Func&& func) const {
+                for(std::size_t i = FirstEventAfter(mChangedEvents, since); i < mChangedEvents.size(); ++i) {
+                    const ComponentEvent& event = mChangedEvents[i];
+                    if(Contains(event.entityID) && GetChangedTick(event.entityID) == event.tick) func(event.entityID);
+                }
+            }
+
+            /**
+             * @brief Appelle func(entityID) pour chaque suppression de composant postérieure à since
+             * 
+             * L'entité peut avoir été détruite depuis, ou avoir reçu un nouveau composant du même type.
+             * 
+             * @tparam Func
+             * @param since
+             * @param func
+             */
+            template<typename Func>
+            void ForEachRemoved(ChangeTick since, Func&& func) const {
+                for(std::size_t i = FirstEventAfter(mRemovedEvents, since); i < mRemovedEvents.size(); ++i) func(mRemovedEvents[i].entityID);
+            }
+
+            /**
+             * @brief Oublie les évènements datés de upTo ou avant
+             * 
+             * @param upTo
+             */
+            void TrimEvents(ChangeTick upTo) override {
+                std::size_t added = FirstEventAfter(mAddedEvents, upTo);
+                std::size_t removed = FirstEventAfter(mRemovedEvents, upTo);
+
+                mAddedEvents.erase(mAddedEvents.begin(), mAddedEvents.begin() + added);
+                mChangedEvents.erase(mChangedEvents.begin(), mChangedEvents.begin() + FirstEventAfter(mChangedEvents, upTo));
+                mRemovedEvents.erase(mRemovedEvents.begin(), mRemovedEvents.begin() + removed);
+
+                mAddedCursor = mAddedCursor > added ? mAddedCursor - added : 0;
+                mRemovedCursor = mRemovedCursor > removed ? mRemovedCursor - removed : 0;
+            }
+
+            /**
+             * @brief Ajoute un observateur appelé juste après chaque ajout de composant (voir Registry::OnAdd)
+             * 
+             * @param callback
+             * @return ObserverID
+             */
+            ObserverID AddOnAdd(std::function<void(EntityID, T&)> callback) {
+                mOnAdd.push_back({mNextObserverID, std::move(callback)});
+                return mNextObserverID++;
+            }
+
+            /**
+             * @brief Ajoute un observateur appelé juste avant chaque suppression de composant (voir Registry::OnRemove)
+             * 
+             * @param callback
+             * @return ObserverID
+             */
+            ObserverID AddOnRemove(std::function<void(EntityID, T&)> callback) {
+                mOnRemove.push_back({mNextObserverID, std::move(callback)});
+                return mNextObserverID++;
+            }
+
+            /**
+             * @brief Ajoute un observateur des ajouts, appelé au prochain point de synchronisation
+             * 
+             * Seuls les ajouts postérieurs à cet appel lui sont transmis.
+             * 
+             * @param callback
+             * @return ObserverID
+             */
+            ObserverID AddOnAddDeferred(std::function<void(EntityID)> callback) {
+                if(mOnAddDeferred.empty()) mAddedCursor = mAddedEvents.size();
+                mOnAddDeferred.push_back({mNextObserverID, std::move(callback)});
+                return mNextObserverID++;
+            }
+
+            /**
+             * @brief Ajoute un observateur des suppressions, appelé au prochain point de synchronisation
+             * 
+             * Seules les suppressions postérieures à cet appel lui sont transmises.
+             * 
+             * @param callback
+             * @return ObserverID
+             */
+            ObserverID AddOnRemoveDeferred(std::function<void(EntityID)> callback) {
+                if(mOnRemoveDeferred.empty()) mRemovedCursor = mRemovedEvents.size();
+                mOnRemoveDeferred.push_back({mNextObserverID, std::move(callback)});
+                return mNextObserverID++;
+            }
+
+            /**
+             * @brief Retire un observateur, quel que soit son type
+             * 
+             * @param id
+             */
+            void RemoveObserver(ObserverID id) {
+                auto matches = [id](const auto& observer) { return observer.id == id; };
+                std::erase_if(mOnAdd, matches);
+                std::erase_if(mOnRemove, matches);
+                std::erase_if(mOnAddDeferred, matches);
+                std::erase_if(mOnRemoveDeferred, matches);
+            }
+
+            /**
+             * @brief Appelle les observateurs immédiats d'ajout (par le registre, une fois le composant complètement ajouté)
+             * 
+             * @param entityID
+             * @param component
+             */
+            void NotifyAdded(EntityID entityID, T& component) {
+                for(auto& observer : mOnAdd) observer.callback(entityID, component);
+            }
+
+            /**
+             * @brief Appelle les observateurs immédiats de suppression pour tous les composants du stockage
+             * 
+             * Utilisé avant un Clear qui correspond à une vraie suppression (voir Registry::RemoveComponentFromAll).
+             */
+            void NotifyRemovingAll() {
+                if(mOnRemove.empty()) return;
+                for(EntityID entityID : mEntities) NotifyRemoving(entityID);
+            }
+
+            /**
+             * @brief Appelle les observateurs différés pour les ajouts et suppressions survenus depuis le dernier appel
+             * 
+             * Les évènements sont transmis dans l'ordre : l'entité peut avoir perdu (ou retrouvé) son composant depuis.
+             */
+            void DispatchDeferred() override {
+                // Les index sont utilisés à la place d'itérateurs : un observateur peut ajouter ou retirer des composants
+                for(; mAddedCursor < mAddedEvents.size(); ++mAddedCursor) {
+                    EntityID entityID = mAddedEvents[mAddedCursor].entityID;
+                    for(std::size_t i = 0; i < mOnAddDeferred.size(); ++i) mOnAddDeferred[i].callback(entityID);
+                }
+
+                for(; mRemovedCursor < mRemovedEvents.size(); ++mRemovedCursor) {
+                    EntityID entityID = mRemovedEvents[mRemovedCursor].entityID;
+                    for(std::size_t i = 0; i < mOnRemoveDeferred.size(); ++i) mOnRemoveDeferred[i].callback(entityID);
                 }
-                mComponents.clear();
             }
 
             /**
              * @brief Récupère un pointeur vers le composant associé à l'entityID
              * 
-             * @param entityID 
+             * @param entityID
              * @return T* Un pointeur vers le composant demandé (nullptr si introuvable)
              */
             T* Get(EntityID entityID, int index = 0) {
-                auto it = mComponents.find(entityID);
-                return (it != mComponents.end() && index < it->second.size()) ? it->second[index] : nullptr;
+                if(!Contains(entityID) || index < 0) return nullptr;
+
+                if constexpr (IsPacked) {
+                    return index == 0 ? Slot(mSparse[EntityIndex(entityID)]) : nullptr;
+                } else {
+                    auto& list = mLists[mSparse[EntityIndex(entityID)]];
+                    return (static_cast<std::size_t>(index) < list.size()) ? list[index] : nullptr;
+                }
             }
 
             /**
              * @brief Récupère un tableau de composants du type donné, associé à l'entityID
              * 
-             * @param entityID 
+             * @param entityID
              * @return std::vector<T*> Un tableau de pointeurs vers les composants demandés
              */
             std::vector<T*> GetMany(EntityID entityID) {
-                auto it = mComponents.find(entityID);
-                return (it != mComponents.end()) ? it->second : std::vector<T*>();
+                if(!Contains(entityID)) return std::vector<T*>();
+
+                if constexpr (IsPacked) return { Slot(mSparse[EntityIndex(entityID)]) };
+                else return mLists[mSparse[EntityIndex(entityID)]];
             }
 
             /**
-             * @brief Renvoie une référence vers le composant associé à l'entityID
+             * @brief Ajoute au tableau donné les composants associés à l'entityID (sans allocation si le tableau a la capacité suffisante)
              * 
              * @param entityID 
-             * @return T& 
+             * @param out 
              */
-            T& GetRef(EntityID entityID, int index = 0) {
-                auto it = mComponents.find(entityID);
-                if(it == mComponents.end() || (it->second.size() < index)) throw std::runtime_error("this entity does not have such a component");
-                return *(mComponents.at(entityID)[index]);
+            void GetMany(EntityID entityID, std::vector<T*>& out) {
+                if(!Contains(entityID)) return;
+
+                if constexpr (IsPacked) out.push_back(Slot(mSparse[EntityIndex(entityID)]));
+                else out.insert(out.end(), mLists[mSparse[EntityIndex(entityID)]].begin(), mLists[mSparse[EntityIndex(entityID)]].end());
             }
 
             /**
-             * @brief Renvoie une réfèrence vers la table entière de stockage de composants
+             * @brief Renvoie une référence vers le composant associé à l'entityID
              * 
-             * @return const std::unordered_map<EntityID, std::vector<T*>>& 
+             * @param entityID
+             * @return T&
              */
-            const std::unordered_map<EntityID, std::vector<T*>>& GetRaw() const {
-                return mComponents;
+            T& GetRef(EntityID entityID, int index = 0) {
+                T* component = Get(entityID, index);
+                if(!component) throw std::runtime_error("this entity does not have such a component");
+                return *component;
             }
     };
-}
\ No newline at end of file
+}
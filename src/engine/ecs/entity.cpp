@@ -6,7 +6,7 @@ namespace Engine::ECS {
     
     std::string Entity::ToString() const {
         std::string output = "\n========== Entity";
-        output += ("\n- ID : " + std::to_string(this->mID));
+        output += ("\n- ID : " + std::to_string(this->mID) + " (index " + std::to_string(EntityIndex(mID)) + ", generation " + std::to_string(EntityGeneration(mID)) + ")");
 
         auto tagList = mRegistry->GetTags(GetID());
         if(tagList.size()) {
@@ -25,18 +25,18 @@ namespace Engine::ECS {
     }
 
     bool Entity::IsValid() const {
-        return (mID > 0 && mRegistry && mRegistry->IsValidEntity(mID));
+        return (mID != NULL_ENTITY && mRegistry && mRegistry->IsValidEntity(mID));
     }
 
     EntityID Entity::GetID() const {
         return mID;
     }
     
-    void Entity::AddTag(std::string tag) {
+    void Entity::AddTag(std::string_view tag) {
         mRegistry->AddTag(GetID(), tag);
     }
 
-    bool Entity::HasTag(std::string tag) {
+    bool Entity::HasTag(std::string_view tag) {
         return mRegistry->HasTag(GetID(), tag);
     }
 
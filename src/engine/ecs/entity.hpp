@@ -30,7 +30,7 @@ namespace Engine::ECS {
              * @param id 
              * @param registry 
              */
-            Entity(EntityID id = -1, Registry* registry = nullptr);
+            Entity(EntityID id = NULL_ENTITY, Registry* registry = nullptr);
             /**
              * @brief Retourne l'identifiant EntityID de cette
              * 
@@ -42,7 +42,7 @@ namespace Engine::ECS {
              * @brief Renvoie true si l'entité est valide, false sinon
              * 
              * Les critères sont : 
-             * - mID > 0
+             * - mID != NULL_ENTITY
              * - mRegistry != nullptr
              * - mRegistry->IsValidEntity(mID) == true
              * 
@@ -68,19 +68,19 @@ namespace Engine::ECS {
             /**
              * @brief Ajoute un tag à l'entité actuelle
              * 
-             * Cette méthode est un wrapper sur Registry->AddTag(EntityID, std::string)
+             * Cette méthode est un wrapper sur Registry->AddTag(EntityID, std::string_view)
              * @param tag 
              */
-            void AddTag(std::string tag);
+            void AddTag(std::string_view tag);
             /**
              * @brief Check si l'entité possède un tag
              * 
-             * Cette méthode est un wrapper autour de Registry->HasTag(EntityID, std::string)
+             * Cette méthode est un wrapper autour de Registry->HasTag(EntityID, std::string_view)
              * @param tag 
              * @return true Si l'entité possède le tag
              * @return false Si l'entité ne possède pas le tag
              */
-            bool HasTag(std::string tag);
+            bool HasTag(std::string_view tag);
 
             /**
              * @brief Ajoute un component de type T au registre, référencé sous l'entityID de cette entité
@@ -93,13 +93,7 @@ namespace Engine::ECS {
              */
             template<typename T, typename... Args>
             T& AddComponent(Args&&... args) {
-                mRegistry->AddComponent<T>(mID, std::forward<Args>(args)...);
-                T& component = mRegistry->GetComponent<T>(mID);
-                if constexpr(requires(T t, Entity e) { t.SetEntity(e); }) {
-                    component.SetEntity(*this);
-                }
-
-                return component;
+                return mRegistry->AddComponent<T>(mID, std::forward<Args>(args)...);
             }
 
             /**
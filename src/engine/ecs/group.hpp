@@ -0,0 +1,126 @@
+/**
+ * @file group.hpp
+ * @brief Définit un groupe ECS : la liste persistante des entités qui possèdent un ensemble de composants
+ * 
+ * Un groupe est créé une seule fois par le registre (Registry::GetGroup), puis tenu à jour à chaque ajout ou suppression
+ * de composant. Sa liste d'entités est donc disponible immédiatement à chaque frame, sans rien recalculer.
+ */
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+
+#include "../defs.hpp"
+#include "../constants.hpp"
+
+namespace Engine::ECS {
+    /**
+     * @brief Liste persistante des entités dont la signature contient un masque donné
+     * 
+     * Les entités sont rangées dans un tableau dense (swap-and-pop à la suppression), indexé par un tableau sparse.
+     */
+    class Group {
+        private:
+            static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+            /** @brief Les composants requis pour faire partie du groupe */
+            Signature mMask;
+            /** @brief Tableau dense des entités du groupe */
+            std::vector<EntityID> mEntities;
+            /** @brief Position de chaque entité dans le tableau dense, indexée par EntityIndex */
+            std::vector<std::uint32_t> mSparse;
+
+        public:
+            /**
+             * @brief Construit un groupe vide
+             * 
+             * @param mask Les composants requis pour faire partie du groupe
+             */
+            explicit Group(const Signature& mask) : mMask(mask) {}
+
+            /**
+             * @brief Renvoie les composants requis pour faire partie du groupe
+             * 
+             * @return const Signature&
+             */
+            const Signature& GetMask() const { return mMask; }
+
+            /**
+             * @brief Vérifie si une signature correspond au groupe
+             * 
+             * @param signature
+             * @return true
+             * @return false
+             */
+            bool Matches(const Signature& signature) const { return (signature & mMask) == mMask; }
+
+            /**
+             * @brief Renvoie les entités du groupe (aucun calcul, la liste est tenue à jour par le registre)
+             * 
+             * @return const std::vector<EntityID>&
+             */
+            const std::vector<EntityID>& GetEntities() const { return mEntities; }
+
+            /**
+             * @brief Renvoie le nombre d'entités du groupe
+             * 
+             * @return std::size_t
+             */
+            std::size_t Size() const { return mEntities.size(); }
+
+            /**
+             * @brief Vérifie si une entité fait partie du groupe
+             * 
+             * @param entityID
+             * @return true
+             * @return false
+             */
+            bool Contains(EntityID entityID) const {
+                std::uint32_t entityIndex = EntityIndex(entityID);
+                return entityIndex < mSparse.size() && mSparse[entityIndex] != INVALID_INDEX && mEntities[mSparse[entityIndex]] == entityID;
+            }
+
+            /**
+             * @brief Ajoute une entité au groupe (sans effet si elle y est déjà)
+             * 
+             * @param entityID
+             */
+            void Add(EntityID entityID) {
+                if(Contains(entityID)) return;
+
+                std::uint32_t entityIndex = EntityIndex(entityID);
+                if(entityIndex >= mSparse.size()) mSparse.resize(entityIndex + 1, INVALID_INDEX);
+
+                mSparse[entityIndex] = static_cast<std::uint32_t>(mEntities.size());
+                mEntities.push_back(entityID);
+            }
+
+            /**
+             * @brief Retire une entité du groupe, la dernière entité prend sa place
+             * 
+             * @param entityID
+             */
+            void Remove(EntityID entityID) {
+                if(!Contains(entityID)) return;
+
+                std::uint32_t index = mSparse[EntityIndex(entityID)];
+                EntityID last = mEntities.back();
+
+                mEntities[index] = last;
+                mSparse[EntityIndex(last)] = index;
+
+                mEntities.pop_back();
+                mSparse[EntityIndex(entityID)] = INVALID_INDEX;
+            }
+
+            /**
+             * @brief Vide le groupe
+             * 
+             */
+            void Clear() {
+                mEntities.clear();
+                mSparse.clear();
+            }
+    };
+}
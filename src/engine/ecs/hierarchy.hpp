@@ -1,22 +1,43 @@
+/**
+ * @file hierarchy.hpp
+ * @brief Définit les composants de la hiérarchie d'entités (liens parent, premier enfant, frères)
+ * 
+ * Les enfants d'une entité forment une liste doublement chaînée : le parent connaît son premier et son dernier enfant,
+ * chaque enfant connaît son parent et ses frères. Aucun noeud n'est alloué, et les deux composants sont trivialement copiables.
+ * Les liens sont tenus à jour par Registry::AddChild, Registry::RemoveChild et Registry::DestroyEntity : ils ne doivent pas
+ * être modifiés ni retirés à la main. Pour parcourir la hiérarchie, voir Registry::ForEachChild, Registry::ForEachDescendant et
+ * Registry::GetHierarchyOrder.
+ */
 #pragma once
 
+#include <cstdint>
+
 #include "component.hpp"
-#include <set>
 
 namespace Engine::ECS {
     /**
-     * @brief Structure de données qui définit un composant "parent" poru stocker un id vers une entité parente dans la hiérarchie si besoin
+     * @brief Composant porté par un enfant : son parent et ses frères dans la hiérarchie
      * 
      */
     struct Parent : public Component {
-        EntityID id;
+        /** @brief L'entité parente (NULL_ENTITY si le lien a été retiré sans supprimer le composant) */
+        EntityID id = NULL_ENTITY;
+        /** @brief Le frère précédent dans la liste des enfants du parent */
+        EntityID previousSibling = NULL_ENTITY;
+        /** @brief Le frère suivant dans la liste des enfants du parent */
+        EntityID nextSibling = NULL_ENTITY;
     };
 
     /**
-     * @brief Equivalent de la structure parent mais pour gérer les enfants dans une entité
+     * @brief Composant porté par un parent : le début et la fin de la liste de ses enfants
      * 
      */
     struct Children : public Component {
-        std::set<EntityID> ids;
+        /** @brief Le premier enfant (NULL_ENTITY s'il n'y en a aucun) */
+        EntityID first = NULL_ENTITY;
+        /** @brief Le dernier enfant, pour ajouter un enfant en O(1) */
+        EntityID last = NULL_ENTITY;
+        /** @brief Le nombre d'enfants */
+        std::uint32_t count = 0;
     };
-}
\ No newline at end of file
+}
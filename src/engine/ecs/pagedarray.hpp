@@ -0,0 +1,99 @@
+/**
+ * @file pagedarray.hpp
+ * @brief Définit un tableau paginé, utilisé par le registre pour les données indexées par EntityIndex
+ * 
+ * Le tableau grandit page par page (ENTITY_PAGE_SIZE éléments) : un agrandissement ne déplace jamais les éléments existants,
+ * et la table des pages est allouée une fois pour toutes. Un thread peut donc lire les éléments existants pendant qu'un autre
+ * agrandit le tableau (création d'entités par le CommandBuffer pendant l'exécution parallèle des systèmes).
+ */
+#pragma once
+
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+
+#include "../constants.hpp"
+
+namespace Engine::ECS {
+    /**
+     * @brief Tableau paginé qui ne fait que grandir, avec une taille maximale fixée à la construction
+     * 
+     * @tparam T
+     */
+    template<typename T>
+    class PagedArray {
+        private:
+            /** @brief Nombre d'entrées de la table des pages */
+            std::size_t mPageCount;
+            /** @brief Table des pages, allouée à la construction (une page n'est allouée qu'au premier besoin) */
+            std::unique_ptr<std::unique_ptr<T[]>[]> mPages;
+            /** @brief Nombre d'éléments utilisés */
+            std::atomic<std::size_t> mSize = 0;
+
+            /**
+             * @brief Alloue les pages nécessaires pour contenir count éléments
+             * 
+             * @param count
+             */
+            void AllocatePages(std::size_t count) {
+                if(count > mPageCount * ENTITY_PAGE_SIZE) throw std::runtime_error("PagedArray: capacity exceeded");
+
+                for(std::size_t page = 0; page * ENTITY_PAGE_SIZE < count; ++page) {
+                    if(!mPages[page]) mPages[page] = std::make_unique<T[]>(ENTITY_PAGE_SIZE);
+                }
+            }
+
+        public:
+            /**
+             * @brief Construit un tableau vide
+             * 
+             * @param maxSize Le nombre maximum d'éléments
+             */
+            explicit PagedArray(std::size_t maxSize)
+                : mPageCount((maxSize + ENTITY_PAGE_SIZE - 1) / ENTITY_PAGE_SIZE), mPages(std::make_unique<std::unique_ptr<T[]>[]>(mPageCount)) {}
+
+            /**
+             * @brief Renvoie le nombre d'éléments utilisés
+             * 
+             * @return std::size_t
+             */
+            std::size_t Size() const { return mSize.load(std::memory_order_acquire); }
+
+            T& operator[](std::size_t index) { return mPages[index / ENTITY_PAGE_SIZE][index % ENTITY_PAGE_SIZE]; }
+            const T& operator[](std::size_t index) const { return mPages[index / ENTITY_PAGE_SIZE][index % ENTITY_PAGE_SIZE]; }
+
+            /**
+             * @brief Ajoute un élément à la fin du tableau
+             * 
+             * @param value
+             */
+            void PushBack(const T& value) {
+                std::size_t size = mSize.load(std::memory_order_relaxed);
+                AllocatePages(size + 1);
+
+                (*this)[size] = value;
+                // L'élément est écrit avant d'être visible par les lecteurs qui testent Size()
+                mSize.store(size + 1, std::memory_order_release);
+            }
+
+            /**
+             * @brief Alloue à l'avance les pages nécessaires pour contenir capacity éléments, sans changer la taille
+             * 
+             * @param capacity
+             */
+            void Reserve(std::size_t capacity) {
+                AllocatePages(capacity);
+            }
+
+            /**
+             * @brief Affecte une valeur à tous les éléments utilisés
+             * 
+             * @param value
+             */
+            void Fill(const T& value) {
+                std::size_t size = Size();
+                for(std::size_t i = 0; i < size; ++i) (*this)[i] = value;
+            }
+    };
+}
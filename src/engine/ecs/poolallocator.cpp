@@ -0,0 +1,44 @@
+#include "poolallocator.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace Engine::ECS {
+    PoolAllocator::PoolAllocator(std::size_t size, std::size_t alignment) : mAlignment(std::max(alignment, alignof(void*))) {
+        mSlotSize = (std::max(size, sizeof(void*)) + mAlignment - 1) / mAlignment * mAlignment;
+    }
+
+    PoolAllocator::~PoolAllocator() {
+        Release();
+    }
+
+    void* PoolAllocator::Allocate() {
+        if(mFreeList) {
+            void* slot = mFreeList;
+            mFreeList = *static_cast<void**>(slot);
+            return slot;
+        }
+
+        if(mCursor == COMPONENT_POOL_BLOCK_SIZE) {
+            mBlocks.push_back(static_cast<std::byte*>(::operator new(mSlotSize * COMPONENT_POOL_BLOCK_SIZE, std::align_val_t(mAlignment))));
+            mCursor = 0;
+        }
+
+        return mBlocks.back() + (mCursor++) * mSlotSize;
+    }
+
+    void PoolAllocator::Deallocate(void* slot) {
+        *static_cast<void**>(slot) = mFreeList;
+        mFreeList = slot;
+    }
+
+    void PoolAllocator::Release() {
+        for(std::byte* block : mBlocks) {
+            ::operator delete(block, std::align_val_t(mAlignment));
+        }
+
+        mBlocks.clear();
+        mCursor = COMPONENT_POOL_BLOCK_SIZE;
+        mFreeList = nullptr;
+    }
+}
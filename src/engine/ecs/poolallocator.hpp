@@ -0,0 +1,64 @@
+/**
+ * @file poolallocator.hpp
+ * @brief Allocateur par blocs pour les composants polymorphiques (Behaviour)
+ */
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "../constants.hpp"
+
+namespace Engine::ECS {
+    /**
+     * @brief Pool d'emplacements de taille fixe, découpés dans des blocs de COMPONENT_POOL_BLOCK_SIZE emplacements
+     * 
+     * Les emplacements libérés sont chaînés dans une free-list et réutilisés en priorité.
+     * Les blocs ne sont rendus au système qu'en une fois, par Release (ou à la destruction du pool).
+     * Le pool ne construit ni ne détruit rien : il ne gère que la mémoire.
+     */
+    class PoolAllocator {
+        private:
+            /** @brief Taille d'un emplacement (au moins un pointeur, pour la free-list) */
+            std::size_t mSlotSize;
+            std::size_t mAlignment;
+            /** @brief Les blocs alloués */
+            std::vector<std::byte*> mBlocks;
+            /** @brief Nombre d'emplacements déjà distribués dans le dernier bloc */
+            std::size_t mCursor = COMPONENT_POOL_BLOCK_SIZE;
+            /** @brief Premier emplacement libre (chaque emplacement libre contient l'adresse du suivant) */
+            void* mFreeList = nullptr;
+
+        public:
+            /**
+             * @brief Construit un pool vide
+             * 
+             * @param size La taille d'un objet
+             * @param alignment L'alignement d'un objet
+             */
+            PoolAllocator(std::size_t size, std::size_t alignment);
+            ~PoolAllocator();
+            PoolAllocator(const PoolAllocator&) = delete;
+            PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+            /**
+             * @brief Renvoie un emplacement non initialisé
+             * 
+             * @return void* 
+             */
+            void* Allocate();
+
+            /**
+             * @brief Rend un emplacement au pool (l'objet doit déjà avoir été détruit)
+             * 
+             * @param slot 
+             */
+            void Deallocate(void* slot);
+
+            /**
+             * @brief Libère tous les blocs d'un coup, sans appeler de destructeur
+             * 
+             */
+            void Release();
+    };
+}
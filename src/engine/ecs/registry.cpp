@@ -1,116 +1,366 @@
 #include "registry.hpp"
 #include "hierarchy.hpp"
+#include "commandbuffer.hpp"
 
 namespace Engine::ECS {
-    Registry::Registry() {
-        // Initialise la queue d'ids entités disponibles
-        for(EntityID i = 0; i < MAX_ENTITIES; ++i) {
-            mAvailableEntityIDs.push(i);
+    Registry::Registry(StorageBackend backend)
+        : mTagMasks(MAX_ENTITIES), mEntityHandles(MAX_ENTITIES), mSignatures(MAX_ENTITIES), mBackend(backend) {
+        if(mBackend == StorageBackend::Archetype) mArchetypes = std::make_unique<ArchetypeStorage>();
+        mCommandBuffer = std::make_unique<CommandBuffer>(*this);
+    }
+
+    Registry::~Registry() {
+        Clear();
+    }
+
+    void Registry::ResetEntityHandles() {
+        mFreeIndices.clear();
+
+        // La liste est utilisée comme une pile : on la remplit à l'envers pour distribuer les petits index en premier
+        for(std::uint32_t i = static_cast<std::uint32_t>(mEntityHandles.Size()); i-- > 0;) {
+            if(EntityIndex(mEntityHandles[i]) == i) {
+                mEntityHandles[i] = MakeEntityID(ENTITY_INDEX_MASK, EntityGeneration(mEntityHandles[i]) + 1);
+            }
+
+            mFreeIndices.push_back(i);
         }
     }
 
     void Registry::Print() {
         LOG_INFO("==== Registry ====");
-        LOG_INFO("next entityID : " + std::to_string(mAvailableEntityIDs.front()));
+        LOG_INFO("entity capacity : " + std::to_string(mEntityHandles.Size()) + " (" + std::to_string(mFreeIndices.size()) + " free)");
         LOG_INFO("storages : " + std::to_string(mStorages.size()));
     }
 
+    StorageBackend Registry::GetStorageBackend() const {
+        return mBackend;
+    }
+
     Scene::Scene& Registry::GetScene() {
         return *mScene;
     }
 
     EntityID Registry::CreateEntity() {
-        if(mAvailableEntityIDs.empty()) throw std::runtime_error("Registry::CreateEntity: no available entity ID was found");
-        EntityID entityID = mAvailableEntityIDs.front();
-        mAvailableEntityIDs.pop();
-        mLivingEntities.insert(entityID);
+        if(mFreeIndices.empty()) {
+            // Aucun index à recycler : on agrandit les tableaux d'un index (les pages sont allouées au besoin)
+            std::size_t entityIndex = mEntityHandles.Size();
+            if(entityIndex >= MAX_ENTITIES) throw std::runtime_error("Registry::CreateEntity: no available entity ID was found");
+
+            EntityID entityID = MakeEntityID(static_cast<std::uint32_t>(entityIndex), 0);
+            mSignatures.PushBack(Signature());
+            mTagMasks.PushBack(TagMask());
+            mEntityHandles.PushBack(entityID);
+
+            return entityID;
+        }
+
+        std::uint32_t entityIndex = mFreeIndices.back();
+        mFreeIndices.pop_back();
+
+        EntityID entityID = MakeEntityID(entityIndex, EntityGeneration(mEntityHandles[entityIndex]));
+        mEntityHandles[entityIndex] = entityID;
 
         return entityID;
     }
 
+    void Registry::ReserveEntities(std::size_t count) {
+        if(count > MAX_ENTITIES) count = MAX_ENTITIES;
+
+        mEntityHandles.Reserve(count);
+        mSignatures.Reserve(count);
+        mTagMasks.Reserve(count);
+        mFreeIndices.reserve(count);
+    }
+
     void Registry::DestroyEntity(EntityID entityID) {
+        if(!IsValidEntity(entityID)) return;
+
+        // La hiérarchie est réparée avant la destruction : l'entité quitte la liste de son parent, ses enfants deviennent des racines
+        if(HasComponent<Parent>(entityID)) Unlink(entityID);
+        if(HasComponent<Children>(entityID)) DetachChildren(entityID);
+
         for(auto& [_, storage] : mStorages) {
             storage->Remove(entityID);
         }
+        if(mArchetypes) mArchetypes->Destroy(entityID);
 
-        mTags[entityID].clear();
-        mLivingEntities.erase(entityID);
-        mAvailableEntityIDs.push(entityID);
+        TagMask& tags = mTagMasks[EntityIndex(entityID)];
+        if(tags.any()) {
+            for(TagID tag = 0; tag < mTagIndex.size(); ++tag) {
+                if(tags.test(tag)) mTagIndex[tag].Remove(entityID);
+            }
+            tags.reset();
+        }
+        SetSignature(entityID, Signature());
+
+        // La génération suivante invalide tous les identifiants qui désignent encore cette entité
+        std::uint32_t entityIndex = EntityIndex(entityID);
+        mEntityHandles[entityIndex] = MakeEntityID(ENTITY_INDEX_MASK, EntityGeneration(entityID) + 1);
+        mFreeIndices.push_back(entityIndex);
     }
 
-    bool Registry::IsValidEntity(EntityID entityID) {
-        return mLivingEntities.find(entityID) != mLivingEntities.end();
+    CommandBuffer& Registry::GetCommandBuffer() {
+        return *mCommandBuffer;
+    }
+
+    void Registry::FlushCommands() {
+        mCommandBuffer->Flush();
+
+        // Les observateurs différés peuvent eux-mêmes modifier le registre : la liste des stockages est parcourue par copie
+        mFlushStorages.clear();
+        for(auto& [_, storage] : mStorages) mFlushStorages.push_back(storage);
+        for(IComponentStorage* storage : mFlushStorages) storage->DispatchDeferred();
+
+        for(auto& [_, storage] : mStorages) storage->ReleaseRemoved();
+
+        // Les systèmes exécutés en parallèle lisent l'ordre de la hiérarchie sans le recalculer
+        if(mHierarchyDirty) RebuildHierarchyOrder();
+    }
+
+    void Registry::TrimEvents(ChangeTick upTo) {
+        for(auto& [_, storage] : mStorages) storage->TrimEvents(upTo);
     }
 
     void Registry::Clear() {
+        mCommandBuffer->Clear();
+
+        // Les archétypes détruisent leurs composants avant que les stockages qui les référencent ne soient supprimés
+        if(mArchetypes) mArchetypes->Clear();
+
         for(auto& [typeID, storage] : mStorages) {
             storage->Clear();
             delete storage;
         }
 
         mStorages.clear();
-        mTags.clear();
+        mTagMasks.Fill(TagMask());
+        for(auto& tagEntities : mTagIndex) tagEntities.Clear();
+        mSignatures.Fill(Signature());
+        for(auto& group : mGroups) group->Clear();
+        mHierarchyOrder.clear();
+        mHierarchyDirty = false;
+        mHierarchyVersion++;
+
+        ResetEntityHandles();
+    }
+
+    void Registry::SetSignature(EntityID entityID, const Signature& signature) {
+        Signature& current = mSignatures[EntityIndex(entityID)];
+
+        for(auto& group : mGroups) {
+            bool before = group->Matches(current);
+            bool after = group->Matches(signature);
 
-        for(EntityID i = 0; i < MAX_ENTITIES; ++i) {
-            mAvailableEntityIDs.push(i);
+            if(!before && after) group->Add(entityID);
+            else if(before && !after) group->Remove(entityID);
         }
+
+        current = signature;
     }
 
-    void Registry::AddTag(EntityID entityID, std::string tag) {
-        mTags[entityID].emplace(tag);
+    void Registry::GetEntityIDsMatching(const Signature& mask, std::vector<EntityID>& out) const {
+        out.clear();
+
+        // Un index libre a une signature vide : le test sur l'index ne sert que pour un masque vide
+        std::size_t capacity = mEntityHandles.Size();
+        for(std::size_t i = 0; i < capacity; ++i) {
+            if((mSignatures[i] & mask) == mask && EntityIndex(mEntityHandles[i]) == i) out.push_back(mEntityHandles[i]);
+        }
     }
 
-    bool Registry::HasTag(EntityID entityID, std::string tag) {
-        return mTags[entityID].find(tag) != mTags[entityID].end();
+    void Registry::AddTag(EntityID entityID, std::string_view tag) {
+        AddTag(entityID, InternTag(tag));
     }
 
-    std::set<std::string> Registry::GetTags(EntityID entityID) {
-        return mTags[entityID];
+    void Registry::AddTag(EntityID entityID, TagID tag) {
+        if(!IsValidEntity(entityID) || tag >= MAX_TAGS) return;
+
+        mTagMasks[EntityIndex(entityID)].set(tag);
+        if(tag >= mTagIndex.size()) mTagIndex.resize(tag + 1, ECS::Group(Signature()));
+        mTagIndex[tag].Add(entityID);
     }
 
-    EntityID Registry::GetEntityIDWithTag(std::string targetTag) {
-        for(auto [id, tags] : mTags) {
-            if(tags.find(targetTag) != tags.end())
-                return id;
-        }
+    void Registry::RemoveTag(EntityID entityID, std::string_view tag) {
+        RemoveTag(entityID, FindTag(tag));
+    }
+
+    void Registry::RemoveTag(EntityID entityID, TagID tag) {
+        if(!HasTag(entityID, tag)) return;
 
-        return -1;
+        mTagMasks[EntityIndex(entityID)].reset(tag);
+        mTagIndex[tag].Remove(entityID);
     }
 
-    std::vector<EntityID> Registry::GetEntityIDsWithTag(std::string targetTag) {
-        std::vector<EntityID> result;
+    bool Registry::HasTag(EntityID entityID, std::string_view tag) {
+        return HasTag(entityID, FindTag(tag));
+    }
 
-        for(auto [id, tags] : mTags) {
-            if(tags.find(targetTag) != tags.end())
-                result.push_back(id);
+    bool Registry::HasTag(EntityID entityID, TagID tag) {
+        return tag < MAX_TAGS && IsValidEntity(entityID) && mTagMasks[EntityIndex(entityID)].test(tag);
+    }
+
+    TagMask Registry::GetTagMask(EntityID entityID) const {
+        return IsValidEntity(entityID) ? mTagMasks[EntityIndex(entityID)] : TagMask();
+    }
+
+    std::set<std::string> Registry::GetTags(EntityID entityID) {
+        std::set<std::string> tags;
+
+        TagMask mask = GetTagMask(entityID);
+        for(TagID tag = 0; tag < MAX_TAGS && mask.any(); ++tag) {
+            if(mask.test(tag)) {
+                tags.emplace(GetTagName(tag));
+                mask.reset(tag);
+            }
         }
 
-        return result;
+        return tags;
+    }
+
+    EntityID Registry::GetEntityIDWithTag(std::string_view targetTag) {
+        return GetEntityIDWithTag(FindTag(targetTag));
+    }
+
+    EntityID Registry::GetEntityIDWithTag(TagID targetTag) {
+        const std::vector<EntityID>& entities = GetEntityIDsWithTag(targetTag);
+        return entities.empty() ? NULL_ENTITY : entities.front();
+    }
+
+    const std::vector<EntityID>& Registry::GetEntityIDsWithTag(std::string_view targetTag) {
+        return GetEntityIDsWithTag(FindTag(targetTag));
+    }
+
+    const std::vector<EntityID>& Registry::GetEntityIDsWithTag(TagID targetTag) {
+        static const std::vector<EntityID> empty;
+        return targetTag < mTagIndex.size() ? mTagIndex[targetTag].GetEntities() : empty;
     }
 
     void Registry::AddChild(EntityID parentID, EntityID childID) {
-        // Check if child already has the Parent component or add it, same for the Children component on the parent id
+        if(!IsValidEntity(parentID) || !IsValidEntity(childID)) throw std::runtime_error("Registry::AddChild: invalid entity");
+        if(parentID == childID) throw std::runtime_error("Registry::AddChild: an entity can not be its own child");
+        for(EntityID ancestorID = GetParent(parentID); ancestorID != NULL_ENTITY; ancestorID = GetParent(ancestorID)) {
+            if(ancestorID == childID) throw std::runtime_error("Registry::AddChild: the child is an ancestor of the parent");
+        }
+
+        // Les deux ajouts passent avant toute référence : avec le backend archétype, ils déplacent les composants de l'entité
         if(!HasComponent<Parent>(childID)) AddComponent<Parent>(childID);
         if(!HasComponent<Children>(parentID)) AddComponent<Children>(parentID);
 
-        // now set the parentID in the child
-        GetComponent<Parent>(childID).id = parentID;
+        EntityID currentParentID = GetComponent<Parent>(childID).id;
+        if(currentParentID == parentID) return;
+        if(currentParentID != NULL_ENTITY) Unlink(childID);
+
+        // L'enfant est ajouté à la fin de la liste
+        Children& children = GetComponent<Children>(parentID);
+        Parent& link = GetComponent<Parent>(childID);
+        link.id = parentID;
+        link.previousSibling = children.last;
+        link.nextSibling = NULL_ENTITY;
 
-        // add the child to the list of the parent
-        GetComponent<Children>(parentID).ids.emplace(childID);
+        if(children.last != NULL_ENTITY) GetComponent<Parent>(children.last).nextSibling = childID;
+        else children.first = childID;
+        children.last = childID;
+        children.count++;
+
+        HierarchyChanged();
     }
 
     void Registry::RemoveChild(EntityID parentID, EntityID childID, bool removeComponents) {
         if(!HasComponent<Parent>(childID)) throw std::runtime_error("given childID has no Parent component");
         if(!HasComponent<Children>(parentID)) throw std::runtime_error("given parentID has no Children component");
-
         if(GetComponent<Parent>(childID).id != parentID) throw std::runtime_error("given childID is not linked to the given parentID");
-        if(!GetComponent<Children>(parentID).ids.contains(childID)) throw std::runtime_error("given parentID is not linked to the given childID");
 
-        GetComponent<Parent>(childID).id = -1;
+        Unlink(childID);
+
         if(removeComponents) RemoveComponent<Parent>(childID);
+    }
+
+    void Registry::Unlink(EntityID childID) {
+        Parent& link = GetComponent<Parent>(childID);
+        if(link.id == NULL_ENTITY) return;
+
+        Children& children = GetComponent<Children>(link.id);
+        if(link.previousSibling != NULL_ENTITY) GetComponent<Parent>(link.previousSibling).nextSibling = link.nextSibling;
+        else children.first = link.nextSibling;
+        if(link.nextSibling != NULL_ENTITY) GetComponent<Parent>(link.nextSibling).previousSibling = link.previousSibling;
+        else children.last = link.previousSibling;
+        children.count--;
+
+        EntityID parentID = link.id;
+        link.id = NULL_ENTITY;
+        link.previousSibling = NULL_ENTITY;
+        link.nextSibling = NULL_ENTITY;
+
+        // Un parent sans enfant redevient une feuille (RemoveChild, DestroyEntity ou AddChild vers un autre parent)
+        if(children.count == 0) RemoveComponent<Children>(parentID);
+
+        HierarchyChanged();
+    }
+
+    void Registry::DetachChildren(EntityID parentID) {
+        Children& children = GetComponent<Children>(parentID);
+        EntityID childID = children.first;
+        children.first = NULL_ENTITY;
+        children.last = NULL_ENTITY;
+        children.count = 0;
+
+        while(childID != NULL_ENTITY) {
+            EntityID next = GetComponent<Parent>(childID).nextSibling;
+            RemoveComponent<Parent>(childID);
+            childID = next;
+        }
+
+        HierarchyChanged();
+    }
+
+    EntityID Registry::GetParent(EntityID entityID) {
+        return HasComponent<Parent>(entityID) ? GetComponent<Parent>(entityID).id : NULL_ENTITY;
+    }
+
+    EntityID Registry::GetFirstChild(EntityID entityID) {
+        return HasComponent<Children>(entityID) ? GetComponent<Children>(entityID).first : NULL_ENTITY;
+    }
+
+    EntityID Registry::GetNextSibling(EntityID entityID) {
+        return HasComponent<Parent>(entityID) ? GetComponent<Parent>(entityID).nextSibling : NULL_ENTITY;
+    }
+
+    std::size_t Registry::GetChildCount(EntityID entityID) {
+        return HasComponent<Children>(entityID) ? GetComponent<Children>(entityID).count : 0;
+    }
+
+    void Registry::DestroySubtree(EntityID rootID) {
+        if(!IsValidEntity(rootID)) return;
+
+        mSubtree.clear();
+        ForEachDescendant(rootID, [this](EntityID descendantID) { mSubtree.push_back(descendantID); });
+
+        // Les feuilles d'abord : chaque destruction ne fait que retirer une entité sans enfant de la liste de son parent
+        for(std::size_t i = mSubtree.size(); i-- > 0;) DestroyEntity(mSubtree[i]);
+        DestroyEntity(rootID);
+    }
+
+    const std::vector<EntityID>& Registry::GetHierarchyOrder() {
+        if(mHierarchyDirty) RebuildHierarchyOrder();
+        return mHierarchyOrder;
+    }
+
+    void Registry::RebuildHierarchyOrder() {
+        mHierarchyOrder.clear();
+
+        if(ComponentStorage<Children>* storage = GetStorage<Children>()) {
+            for(EntityID entityID : storage->GetEntities()) {
+                if(GetParent(entityID) == NULL_ENTITY) mHierarchyOrder.push_back(entityID);
+            }
+        }
+
+        // Parcours en largeur : la liste elle-même sert de file, chaque profondeur suit la précédente
+        for(std::size_t i = 0; i < mHierarchyOrder.size(); ++i) {
+            for(EntityID childID = GetFirstChild(mHierarchyOrder[i]); childID != NULL_ENTITY; childID = GetNextSibling(childID)) {
+                mHierarchyOrder.push_back(childID);
+            }
+        }
 
-        GetComponent<Children>(parentID).ids.erase(childID);
-        if(removeComponents && GetComponent<Children>(parentID).ids.size() == 0) RemoveComponent<Children>(parentID);
+        mHierarchyDirty = false;
     }
-}
\ No newline at end of file
+}
@@ -8,14 +8,24 @@
 #pragma once
 
 #include <unordered_map>
-#include <queue>
 #include <stdexcept>
 #include <set>
+#include <vector>
+#include <memory>
+#include <new>
+#include <atomic>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 
 #include "../defs.hpp"
 #include "../constants.hpp"
 #include "componentstorage.hpp"
+#include "archetype.hpp"
+#include "view.hpp"
+#include "group.hpp"
+#include "tag.hpp"
+#include "pagedarray.hpp"
 
 #include <engine/core/logger.hpp>
 
@@ -23,31 +33,22 @@
 namespace Engine::Scene { class Scene; }
 
 namespace Engine::ECS {
-    /** @brief Le prochain identifiant de composant pour les storages */
-    inline size_t nextComponentTypeId = 0;
+    class CommandBuffer;
+    class Component;
+
+    /**
+     * @brief Le prochain identifiant de composant pour les storages
+     * 
+     * Atomique : deux systèmes exécutés en parallèle peuvent utiliser pour la première fois deux types différents en même temps.
+     */
+    inline std::atomic<size_t> nextComponentTypeId{0};
     
     /**
      * @brief Classe Registre qui stocke des composants et gère l'attribution des IDs d'entités 
      */
     class Registry {
         friend class Scene::Scene;
-
-        // Templates qui permettent de checker si un composant possède un ::BaseType
-        template<typename, typename = std::void_t<>>
-        struct HasBaseType : std::false_type {};
-
-        template<typename T>
-        struct HasBaseType<T, std::void_t<typename T::BaseType>> : std::true_type {};
-        
-        template<typename T, bool = HasBaseType<T>::value>
-        struct BaseOrSelf {
-            using type = T;
-        };
-
-        template<typename T>
-        struct BaseOrSelf<T, true> {
-            using type = typename T::BaseType;
-        };
+        friend class Snapshot;
 
         private:
             /** @brief Pointeur vers la scène qui possède le registre */
@@ -55,20 +56,100 @@ namespace Engine::ECS {
             
             /** @brief Une table qui associe un type de component à un stockage de composant associé */
             std::unordered_map<size_t, IComponentStorage*> mStorages;
-            /** @brief Une table qui associe un set de tags à un EntityID pour tagger les entités */
-            std::unordered_map<EntityID, std::set<std::string>> mTags;
-            /** 
-             * @brief Une liste des IDs d'entités disponibles de taille MAX_ENTITIES
+            /** @brief Les tags de chaque entité, indexés par EntityIndex (vide pour un index libre) */
+            PagedArray<TagMask> mTagMasks;
+            /**
+             * @brief Index inversé des tags : pour chaque TagID, la liste dense des entités qui le portent
+             * 
+             * Chaque liste est un Group sans composant requis, tenu à jour par AddTag/RemoveTag/DestroyEntity.
+             */
+            std::vector<ECS::Group> mTagIndex;
+            /**
+             * @brief Identifiant courant de chaque index d'entité
              * 
-             * Les entités détruites libèrent leur ID le rendant accessible aux nouvelles, créant un roulement.
-             * Chaque registre à sa propre file d'IDs
+             * Le tableau grandit d'un index à chaque fois qu'aucun index libre n'est disponible, jusqu'à MAX_ENTITIES.
+             * Pour une entité vivante, la case contient son EntityID complet (index + génération).
+             * Pour un index libre, elle contient la génération du prochain identifiant, avec un index invalide :
+             * elle ne peut donc être égale à aucun EntityID, ce qui rend IsValidEntity en O(1).
              */
-            std::queue<EntityID> mAvailableEntityIDs;
+            PagedArray<EntityID> mEntityHandles;
             /**
-             * @brief Tient une liste des IDs actuellement en cours d'utilisation
+             * @brief Liste des index d'entités disponibles
              * 
+             * Les entités détruites libèrent leur index le rendant accessible aux nouvelles, avec une génération incrémentée.
+             * Chaque registre à sa propre liste d'index
              */
-            std::set<EntityID> mLivingEntities;
+            std::vector<std::uint32_t> mFreeIndices;
+
+            /**
+             * @brief Rend tous les index disponibles, en incrémentant la génération des entités encore vivantes
+             * 
+             */
+            void ResetEntityHandles();
+
+            /** @brief Signature de chaque entité, indexée par EntityIndex (vide pour un index libre) */
+            PagedArray<Signature> mSignatures;
+            /** @brief Les groupes persistants du registre, tenus à jour à chaque changement de signature (voir GetGroup) */
+            std::vector<std::unique_ptr<ECS::Group>> mGroups;
+
+            /**
+             * @brief Change la signature d'une entité, et la fait entrer ou sortir des groupes concernés
+             * 
+             * @param entityID 
+             * @param signature La nouvelle signature
+             */
+            void SetSignature(EntityID entityID, const Signature& signature);
+
+            /** @brief Le mode de stockage des composants choisi pour ce registre */
+            StorageBackend mBackend;
+            /** @brief Les archétypes du registre (nullptr avec le backend StorageBackend::SparseSet) */
+            std::unique_ptr<ArchetypeStorage> mArchetypes;
+            /** @brief Les changements structurels différés, appliqués par FlushCommands */
+            std::unique_ptr<CommandBuffer> mCommandBuffer;
+            /** @brief Compteur de changements du registre, partagé par tous ses stockages (voir GetChangeTick) */
+            std::atomic<ChangeTick> mChangeTick = 1;
+            /** @brief Copie de la liste des stockages utilisée par FlushCommands (tableau réutilisé) */
+            std::vector<IComponentStorage*> mFlushStorages;
+
+            /** @brief Les entités de la hiérarchie, triées par profondeur (voir GetHierarchyOrder) */
+            std::vector<EntityID> mHierarchyOrder;
+            /** @brief Vrai si un lien de la hiérarchie a changé depuis le dernier calcul de mHierarchyOrder */
+            bool mHierarchyDirty = false;
+            /** @brief Incrémenté à chaque changement de lien de la hiérarchie (voir GetHierarchyVersion) */
+            std::uint32_t mHierarchyVersion = 1;
+            /** @brief Tableau réutilisé par DestroySubtree */
+            std::vector<EntityID> mSubtree;
+
+            /**
+             * @brief Signale un changement de lien dans la hiérarchie
+             * 
+             */
+            void HierarchyChanged() {
+                mHierarchyDirty = true;
+                mHierarchyVersion++;
+            }
+
+            /**
+             * @brief Retire un enfant de la liste de son parent, sans supprimer son composant Parent
+             * 
+             * Le composant Children du parent est retiré s'il n'a plus d'enfant.
+             * 
+             * @param childID Une entité qui possède un composant Parent
+             */
+            void Unlink(EntityID childID);
+
+            /**
+             * @brief Retire le composant Parent de tous les enfants d'une entité (ils deviennent des racines)
+             * 
+             * @param parentID Une entité qui possède un composant Children
+             */
+            void DetachChildren(EntityID parentID);
+
+            /**
+             * @brief Recalcule mHierarchyOrder par un parcours en largeur depuis les racines, en temps linéaire
+             * 
+             */
+            void RebuildHierarchyOrder();
 
             /**
              * @brief Récupère un stockage de component, le créé s'il n'en existe pas pour ce type de composant
@@ -81,7 +162,17 @@ namespace Engine::ECS {
                 size_t tid = GetComponentTypeID<T>();
 
                 if(mStorages.find(tid) == mStorages.end()) {
-                    mStorages[tid] = new ComponentStorage<T>();
+                    auto* storage = new ComponentStorage<T>();
+                    storage->SetTickSource(&mChangeTick);
+                    mStorages[tid] = storage;
+
+                    // Avec le backend archétype, les composants compacts appartiennent aux chunks des archétypes
+                    if constexpr (ComponentStorage<T>::IsPacked) {
+                        if(mArchetypes) {
+                            storage->SetExternal();
+                            mArchetypes->RegisterType(ComponentInfo::Of<T>(tid, storage));
+                        }
+                    }
                 }
 
                 return static_cast<ComponentStorage<T>*>(mStorages[tid]);
@@ -97,8 +188,9 @@ namespace Engine::ECS {
             ComponentStorage<T>* GetStorage() {
                 size_t tid = GetComponentTypeID<T>();
                 
-                if(mStorages.find(tid) != mStorages.end()) {
-                    return static_cast<ComponentStorage<T>*>(mStorages[tid]);
+                auto it = mStorages.find(tid);
+                if(it != mStorages.end()) {
+                    return static_cast<ComponentStorage<T>*>(it->second);
                 }
 
                 return nullptr;
@@ -108,9 +200,24 @@ namespace Engine::ECS {
             /**
              * @brief Créé un objet Registry.
              * 
-             * Le constructeur remplis la file d'identifiants d'entités de 1 à MAX_ENTITIES
+             * Le registre est vide : la place des entités est allouée au fur et à mesure de leur création (voir ReserveEntities)
+             * 
+             * @param backend Le mode de stockage des composants (sparse sets par défaut)
              */
-            Registry();
+            Registry(StorageBackend backend = StorageBackend::SparseSet);
+
+            /**
+             * @brief Détruit le registre, ainsi que tous ses composants
+             * 
+             */
+            ~Registry();
+
+            /**
+             * @brief Renvoie le mode de stockage des composants de ce registre
+             * 
+             * @return StorageBackend 
+             */
+            StorageBackend GetStorageBackend() const;
 
             /**
              * @brief Affiche un print du registre dans la console
@@ -158,17 +265,56 @@ namespace Engine::ECS {
             /**
              * @brief Renvoie true si l'entité est valide et utilisable, false sinon
              * 
+             * Un identifiant périmé (entité détruite, même si son index a été réutilisé depuis) n'est pas valide.
+             * 
              * @param entityID 
              * @return true 
              * @return false 
              */
-            bool IsValidEntity(EntityID entityID);
+            bool IsValidEntity(EntityID entityID) const {
+                std::uint32_t entityIndex = EntityIndex(entityID);
+                return entityIndex < mEntityHandles.Size() && mEntityHandles[entityIndex] == entityID;
+            }
+
+            /**
+             * @brief Alloue à l'avance la place de count entités (indication, le registre grandit de toute façon à la demande)
+             * 
+             * @param count 
+             */
+            void ReserveEntities(std::size_t count);
+
+            /**
+             * @brief Renvoie le nombre d'index d'entités alloués (entités vivantes et index libres)
+             * 
+             * @return std::size_t 
+             */
+            std::size_t GetEntityCapacity() const { return mEntityHandles.Size(); }
+
+            /**
+             * @brief Renvoie le tampon de commandes du registre
+             * 
+             * Les systèmes et les scripts y enregistrent les changements structurels (création/destruction d'entités,
+             * ajout/suppression de composants) à faire pendant un parcours : ils sont appliqués au prochain FlushCommands.
+             * 
+             * @return CommandBuffer& 
+             */
+            CommandBuffer& GetCommandBuffer();
+
+            /**
+             * @brief Applique toutes les commandes en attente dans le tampon de commandes
+             * 
+             * Appelé par la classe App à chaque point de synchronisation de la boucle.
+             * Appelle ensuite les observateurs différés (voir OnAddDeferred), puis détruit les composants polymorphiques
+             * retirés depuis le point de synchronisation précédent.
+             */
+            void FlushCommands();
 
             /**
              * @brief Nettoie le registre dans son entiereté.
              * 
              * A pour effet de nettoyer tous les componentStorages, y compris la liste de storages du registre.
-             * Nettoie ensuite les tags d'entités, et rend tous les EntityIDs possibles à nouveau disponibles.
+             * Nettoie ensuite les tags d'entités, et rend tous les index d'entités à nouveau disponibles.
+             * Les EntityIDs obtenus avant l'appel ne sont plus valides.
              */
             void Clear();
 
@@ -184,51 +330,393 @@ namespace Engine::ECS {
             std::vector<EntityID> GetEntityIDsWith() {
                 std::vector<EntityID> result;
 
-                if(sizeof...(TComponents) == 0) return result;
+                if constexpr (sizeof...(TComponents) > 0) {
+                    auto view = View<TComponents...>();
+                    result.reserve(view.SizeHint());
 
-                // On récupère le premier stockage pour itérer sur une base minimale
-                auto* baseStorage = GetStorage<std::tuple_element_t<0, std::tuple<TComponents...>>>();
-                if(!baseStorage) return result;
-
-                for (const auto& [entityID, _] : baseStorage->GetRaw()) {
-                    if ((HasComponent<TComponents>(entityID) && ...)) {
-                        result.push_back(entityID);
+                    for(auto it = view.begin(); it != view.end(); ++it) {
+                        result.push_back(std::get<0>(*it));
                     }
                 }
 
                 return result;
             }
 
+            /**
+             * @brief Renvoie une vue sur les entités qui possèdent tous les composants demandés
+             * 
+             * La vue est parcourue de manière paresseuse, sans allocation, en partant du plus petit stockage.
+             * Chaque élément est un tuple (EntityID, Ts&...) : for(auto [id, transform, sprite] : registry.View<Transform, Sprite>())
+             * 
+             * @tparam Ts Les types de composants demandés (const T pour un accès en lecture seule)
+             * @return ECS::View<Ts...> 
+             */
+            template<typename... Ts>
+            ECS::View<Ts...> View() {
+                if(mArchetypes) {
+                    return ECS::View<Ts...>(*mArchetypes, {GetComponentTypeID<StorageType<Ts>>()...}, mSignatures, MakeSignature<Ts...>(), GetStorage<StorageType<Ts>>()...);
+                }
+
+                return ECS::View<Ts...>(mSignatures, MakeSignature<Ts...>(), GetStorage<StorageType<Ts>>()...);
+            }
+
+            /**
+             * @brief Renvoie le groupe persistant des entités qui possèdent tous les composants demandés
+             * 
+             * Le groupe est créé (et rempli) au premier appel, puis tenu à jour par le registre à chaque ajout ou
+             * suppression de composant : sa liste d'entités est ensuite disponible sans aucun calcul.
+             * La référence renvoyée reste valide pendant toute la durée de vie du registre (y compris après Clear).
+             * 
+             * @tparam Ts Les types de composants requis
+             * @return const ECS::Group& 
+             */
+            template<typename... Ts>
+            const ECS::Group& GetGroup() {
+                static_assert(sizeof...(Ts) > 0, "Registry::GetGroup: at least one component type is required");
+                Signature mask = MakeSignature<Ts...>();
+
+                for(auto& group : mGroups) {
+                    if(group->GetMask() == mask) return *group;
+                }
+
+                auto& group = mGroups.emplace_back(std::make_unique<ECS::Group>(mask));
+                std::vector<EntityID> entities;
+                GetEntityIDsMatching(mask, entities);
+                for(EntityID entityID : entities) group->Add(entityID);
+
+                return *group;
+            }
+
+            /**
+             * @brief Renvoie une vue dirigée par le groupe persistant des composants demandés (voir GetGroup)
+             * 
+             * Contrairement à View, le parcours ne passe que par des entités qui correspondent : aucune n'est rejetée.
+             * Avec le backend archétype, les chunks sont déjà groupés par composants : la vue parcourt les archétypes.
+             * 
+             * @tparam Ts Les types de composants demandés (const T pour un accès en lecture seule)
+             * @return ECS::View<Ts...> 
+             */
+            template<typename... Ts>
+            ECS::View<Ts...> Group() {
+                if(mArchetypes) return View<Ts...>();
+
+                return ECS::View<Ts...>(GetGroup<Ts...>().GetEntities(), mSignatures, MakeSignature<Ts...>(), GetStorage<StorageType<Ts>>()...);
+            }
+
+            /**
+             * @brief Renvoie le nombre d'entités qui possèdent un composant de type T
+             * 
+             * @tparam T 
+             * @return std::size_t 
+             */
+            template<typename T>
+            std::size_t Count() {
+                auto* storage = GetStorage<StorageType<T>>();
+                return storage ? storage->Size() : 0;
+            }
+
+            /**
+             * @brief Renvoie la valeur courante du compteur de changements
+             * 
+             * Les ajouts et modifications de composants faits maintenant sont datés de cette valeur.
+             * 
+             * @return ChangeTick 
+             */
+            ChangeTick GetChangeTick() const { return mChangeTick.load(std::memory_order_relaxed); }
+
+            /**
+             * @brief Fait avancer le compteur de changements
+             * 
+             * Appelé par l'ordonnanceur après chaque exécution d'une phase par un système (voir System::GetLastRunTick).
+             * Tous les changements postérieurs à cet appel seront strictement plus récents que la valeur renvoyée.
+             * 
+             * @return ChangeTick La valeur du compteur avant l'appel
+             */
+            ChangeTick AdvanceChangeTick() { return mChangeTick.fetch_add(1, std::memory_order_relaxed); }
+
+            /**
+             * @brief Signale que le composant de type T de l'entité a été modifié
+             * 
+             * Les modifications faites directement sur une référence ne sont pas détectées : elles doivent être signalées
+             * ici (ou faites via Patch) pour que les systèmes réactifs les voient.
+             * 
+             * @tparam T 
+             * @param entityID 
+             */
+            template<typename T>
+            void MarkChanged(EntityID entityID) {
+                auto* storage = GetStorage<StorageType<T>>();
+                if(storage) storage->MarkChanged(entityID);
+            }
+
+            /**
+             * @brief Modifie le composant de type T de l'entité avec func(T&), puis le signale comme modifié
+             * 
+             * @tparam T 
+             * @tparam Func 
+             * @param entityID 
+             * @param func 
+             * @return T& 
+             */
+            template<typename T, typename Func>
+            T& Patch(EntityID entityID, Func&& func) {
+                T& component = GetComponent<T>(entityID);
+                func(component);
+                MarkChanged<T>(entityID);
+                return component;
+            }
+
+            /**
+             * @brief Vérifie si le composant de type T de l'entité a été ajouté après since
+             * 
+             * @tparam T 
+             * @param entityID 
+             * @param since 
+             * @return true 
+             * @return false Si le composant est plus ancien, ou si l'entité n'en possède pas
+             */
+            template<typename T>
+            bool IsAdded(EntityID entityID, ChangeTick since) {
+                auto* storage = GetStorage<StorageType<T>>();
+                return storage && storage->Contains(entityID) && storage->GetAddedTick(entityID) > since;
+            }
+
+            /**
+             * @brief Vérifie si le composant de type T de l'entité a été ajouté ou modifié après since
+             * 
+             * @tparam T 
+             * @param entityID 
+             * @param since 
+             * @return true 
+             * @return false Si le composant n'a pas changé, ou si l'entité n'en possède pas
+             */
+            template<typename T>
+            bool IsChanged(EntityID entityID, ChangeTick since) {
+                auto* storage = GetStorage<StorageType<T>>();
+                return storage && storage->Contains(entityID) && storage->GetChangedTick(entityID) > since;
+            }
+
+            /**
+             * @brief Appelle func(entityID) pour chaque composant de type T ajouté après since (et toujours présent)
+             * 
+             * Le coût est proportionnel au nombre d'ajouts, pas au nombre de composants.
+             * 
+             * @tparam T 
+             * @tparam Func 
+             * @param since 
+             * @param func 
+             */
+            template<typename T, typename Func>
+            void ForEachAdded(ChangeTick since, Func&& func) {
+                auto* storage = GetStorage<StorageType<T>>();
+                if(storage) storage->ForEachAdded(since, std::forward<Func>(func));
+            }
+
+            /**
+             * @brief Appelle func(entityID) pour chaque composant de type T ajouté ou modifié après since (et toujours présent)
+             * 
+             * @tparam T 
+             * @tparam Func 
+             * @param since 
+             * @param func 
+             */
+            template<typename T, typename Func>
+            void ForEachChanged(ChangeTick since, Func&& func) {
+                auto* storage = GetStorage<StorageType<T>>();
+                if(storage) storage->ForEachChanged(since, std::forward<Func>(func));
+            }
+
+            /**
+             * @brief Appelle func(entityID) pour chaque composant de type T retiré après since (entité détruite comprise)
+             * 
+             * @tparam T 
+             * @tparam Func 
+             * @param since 
+             * @param func 
+             */
+            template<typename T, typename Func>
+            void ForEachRemoved(ChangeTick since, Func&& func) {
+                auto* storage = GetStorage<StorageType<T>>();
+                if(storage) storage->ForEachRemoved(since, std::forward<Func>(func));
+            }
+
+            /**
+             * @brief Remplit out avec les entités dont au moins un des composants Ts... a été ajouté ou modifié après since
+             * 
+             * Chaque entité n'apparait qu'une fois. Le coût est proportionnel au nombre de changements.
+             * 
+             * @tparam Ts 
+             * @param since 
+             * @param out Vidé puis rempli (aucune allocation si sa capacité suffit)
+             */
+            template<typename... Ts>
+            void GetEntityIDsChanged(ChangeTick since, std::vector<EntityID>& out) {
+                out.clear();
+                (ForEachChanged<Ts>(since, [&out](EntityID entityID) { out.push_back(entityID); }), ...);
+
+                if constexpr (sizeof...(Ts) > 1) {
+                    std::sort(out.begin(), out.end());
+                    out.erase(std::unique(out.begin(), out.end()), out.end());
+                }
+            }
+
+            /**
+             * @brief Ajoute un observateur appelé juste après chaque ajout d'un composant de type T
+             * 
+             * L'appel est synchrone, sur le thread qui ajoute le composant (en général pendant FlushCommands).
+             * Le composant est complètement ajouté : HasComponent<T> est déjà vrai. L'observateur ne doit pas ajouter ou retirer
+             * de composant de type T (il peut modifier les autres stockages).
+             * 
+             * Les observateurs appartiennent au stockage : Clear() les retire avec lui.
+             * 
+             * @tparam T 
+             * @param callback func(EntityID, T&)
+             * @return ObserverID 
+             */
+            template<typename T>
+            ObserverID OnAdd(std::function<void(EntityID, StorageType<T>&)> callback) {
+                return GetOrCreateStorage<StorageType<T>>()->AddOnAdd(std::move(callback));
+            }
+
+            /**
+             * @brief Ajoute un observateur appelé juste avant chaque suppression d'un composant de type T
+             * 
+             * Appelé aussi quand l'entité est détruite, le composant est encore valide pendant l'appel.
+             * Mêmes restrictions que OnAdd. Clear() ne prévient pas les observateurs : ils sont retirés avec les stockages.
+             * 
+             * @tparam T 
+             * @param callback func(EntityID, T&)
+             * @return ObserverID 
+             */
+            template<typename T>
+            ObserverID OnRemove(std::function<void(EntityID, StorageType<T>&)> callback) {
+                return GetOrCreateStorage<StorageType<T>>()->AddOnRemove(std::move(callback));
+            }
+
+            /**
+             * @brief Ajoute un observateur des ajouts de composants de type T, appelé au prochain FlushCommands
+             * 
+             * Les ajouts sont transmis dans l'ordre où ils ont eu lieu : le composant peut avoir été retiré depuis.
+             * Un observateur différé peut modifier le registre librement.
+             * 
+             * @tparam T 
+             * @param callback func(EntityID)
+             * @return ObserverID 
+             */
+            template<typename T>
+            ObserverID OnAddDeferred(std::function<void(EntityID)> callback) {
+                return GetOrCreateStorage<StorageType<T>>()->AddOnAddDeferred(std::move(callback));
+            }
+
+            /**
+             * @brief Ajoute un observateur des suppressions de composants de type T, appelé au prochain FlushCommands
+             * 
+             * @tparam T 
+             * @param callback func(EntityID)
+             * @return ObserverID 
+             */
+            template<typename T>
+            ObserverID OnRemoveDeferred(std::function<void(EntityID)> callback) {
+                return GetOrCreateStorage<StorageType<T>>()->AddOnRemoveDeferred(std::move(callback));
+            }
+
+            /**
+             * @brief Retire un observateur du stockage de T
+             * 
+             * @tparam T 
+             * @param id 
+             */
+            template<typename T>
+            void RemoveObserver(ObserverID id) {
+                auto* storage = GetStorage<StorageType<T>>();
+                if(storage) storage->RemoveObserver(id);
+            }
+
+            /**
+             * @brief Oublie les évènements de composants datés de upTo ou avant, dans tous les stockages
+             * 
+             * @param upTo 
+             */
+            void TrimEvents(ChangeTick upTo);
+
             /**
              * @brief Renvoie le premier EntityID trouvé pour le tag donné
              * 
              * @param targetTag Tag à chercher
-             * @return EntityID Le premier EntityID qui correspond à la demande dans la liste
+             * @return EntityID Le premier EntityID qui correspond à la demande dans la liste (NULL_ENTITY si aucun)
              */
-            EntityID GetEntityIDWithTag(std::string targetTag);
+            EntityID GetEntityIDWithTag(std::string_view targetTag);
+            EntityID GetEntityIDWithTag(TagID targetTag);
             
             /**
-             * @brief Renvoie une liste d'entityID qui possèdent le tag donné
+             * @brief Renvoie la liste d'entityID qui possèdent le tag donné
+             * 
+             * La liste est celle de l'index inversé : aucune copie ni allocation, mais elle est modifiée par
+             * AddTag/RemoveTag/DestroyEntity (copier la liste avant de détruire des entités en la parcourant).
              * 
              * @param targetTag Le tag à chercher
-             * @return std::vector<EntityID> Liste d'id d'entités qui correspondent
+             * @return const std::vector<EntityID>& Liste d'id d'entités qui correspondent
              */
-            std::vector<EntityID> GetEntityIDsWithTag(std::string targetTag);
+            const std::vector<EntityID>& GetEntityIDsWithTag(std::string_view targetTag);
+            const std::vector<EntityID>& GetEntityIDsWithTag(TagID targetTag);
 
             /* COMPONENT MANAGER PUBLIC SECTION */
             /**
              * @brief Ajoute un nouveau component
              * 
+             * Les composants non polymorphiques sont construits directement dans le stockage compact de leur type.
+             * Les composants polymorphiques (ex : Behaviour) sont construits dans un pool propre à leur type concret, et référencés par le stockage de leur BaseType.
+             * 
              * @tparam T Le type de component à ajouter
              * @tparam Args Liste de types d'arguments pour construire le component
              * @param entityID L'EntityID qui référence le nouveau composant
              * @param args Les arguments pour créer le composant
+             * @return T& Une référence vers le composant créé
              */
             template <typename T, typename... Args>
-            void AddComponent(EntityID entityID, Args&&... args) {
+            T& AddComponent(EntityID entityID, Args&&... args) {
                 using Base = typename BaseOrSelf<T>::type;
 
-                GetOrCreateStorage<Base>()->Add(entityID, new T(std::forward<Args>(args)...));
+                if(!IsValidEntity(entityID)) throw std::runtime_error("Registry::AddComponent: invalid entity");
+
+                T* component = nullptr;
+                if constexpr (ComponentStorage<Base>::IsPacked) {
+                    static_assert(std::is_same_v<T, Base>, "Registry::AddComponent: a non polymorphic component can not be stored as its BaseType");
+                    auto* storage = GetOrCreateStorage<Base>();
+
+                    if(mArchetypes) {
+                        if(storage->Contains(entityID)) throw std::runtime_error("Registry::AddComponent: this entity already has such a component");
+
+                        // L'entité change d'archétype, le composant est construit directement dans son nouveau chunk
+                        component = ::new (mArchetypes->Add(entityID, GetComponentTypeID<Base>())) T(std::forward<Args>(args)...);
+                        storage->Attach(entityID, component);
+                    } else {
+                        component = &storage->Emplace(entityID, std::forward<Args>(args)...);
+                    }
+                } else {
+                    component = &GetOrCreateStorage<Base>()->template Create<T>(entityID, std::forward<Args>(args)...);
+                }
+
+                // Le composant garde son entité en interne (voir Component::GetEntity)
+                if constexpr (std::is_base_of_v<Component, T>) component->SetOwner(entityID, this);
+
+                SetSignature(entityID, mSignatures[EntityIndex(entityID)] | MakeSignature<Base>());
+                GetStorage<Base>()->NotifyAdded(entityID, *component);
+                return *component;
+            }
+
+            /**
+             * @brief Réserve la place de count composants de type T supplémentaires
+             * 
+             * Evite les réallocations successives avant un ajout en masse (voir CommandBuffer::Flush).
+             * 
+             * @tparam T 
+             * @param count 
+             */
+            template<typename T>
+            void Reserve(std::size_t count) {
+                auto* storage = GetOrCreateStorage<typename BaseOrSelf<T>::type>();
+                storage->Reserve(storage->Size() + count);
             }
 
             /**
@@ -242,26 +730,124 @@ namespace Engine::ECS {
                 using Base = typename BaseOrSelf<T>::type;
 
                 auto storage = GetStorage<Base>();
-                if (storage) {
+                if (storage && storage->Contains(entityID)) {
                     storage->Remove(entityID);
+                    if(storage->IsExternal()) mArchetypes->Remove(entityID, GetComponentTypeID<Base>());
+
+                    SetSignature(entityID, mSignatures[EntityIndex(entityID)] & ~MakeSignature<Base>());
+                }
+            }
+
+            /**
+             * @brief Ajoute un composant à toutes les entités qui possèdent les composants With... (et pas encore T)
+             * 
+             * Avec le backend archétype, chaque archétype concerné est déplacé en une seule fois, colonne par colonne.
+             * 
+             * @tparam T Le type de component à ajouter
+             * @tparam With Les composants que les entités doivent déjà posséder
+             * @param component La valeur copiée dans chaque nouveau composant
+             */
+            template<typename T, typename... With>
+            void AddComponentToAll(const T& component = T()) {
+                static_assert(sizeof...(With) > 0, "Registry::AddComponentToAll: at least one filter component is required");
+                using Base = typename BaseOrSelf<T>::type;
+
+                if constexpr (ComponentStorage<Base>::IsPacked) {
+                    if(mArchetypes) {
+                        auto* storage = GetOrCreateStorage<Base>();
+                        (GetOrCreateStorage<StorageType<With>>(), ...);
+
+                        Signature added = MakeSignature<Base>();
+                        mArchetypes->AddToAll(GetComponentTypeID<Base>(), {GetComponentTypeID<StorageType<With>>()...}, [&](EntityID entityID, void* slot) {
+                            T* created = ::new (slot) T(component);
+                            if constexpr (std::is_base_of_v<Component, T>) created->SetOwner(entityID, this);
+                            storage->Attach(entityID, created);
+                            SetSignature(entityID, mSignatures[EntityIndex(entityID)] | added);
+                            storage->NotifyAdded(entityID, *created);
+                        });
+                        return;
+                    }
+                }
+
+                for(EntityID entityID : GetEntityIDsWith<With...>()) {
+                    if(!HasComponent<T>(entityID)) AddComponent<T>(entityID, component);
                 }
             }
 
+            /**
+             * @brief Supprime le composant de type T de toutes les entités qui le possèdent
+             * 
+             * Comme RemoveComponent, les composants polymorphes (scripts) ne sont détruits qu'au prochain point de synchronisation.
+             * 
+             * @tparam T Le type de component à supprimer
+             */
+            template<typename T>
+            void RemoveComponentFromAll() {
+                using Base = typename BaseOrSelf<T>::type;
+
+                auto storage = GetStorage<Base>();
+                if(!storage) return;
+
+                storage->NotifyRemovingAll();
+
+                Signature mask = ~MakeSignature<Base>();
+                for(EntityID entityID : storage->GetEntities()) SetSignature(entityID, mSignatures[EntityIndex(entityID)] & mask);
+
+                storage->RemoveAll();
+                if(storage->IsExternal()) mArchetypes->RemoveFromAll(GetComponentTypeID<Base>());
+            }
+
             /**
              * @brief Renvoie une identifiant unique pour chaque type de composant
              * 
              * La première fois qu'un type T appelle cette méthode, elle créé une constante avec un id unique incrémental
              * Les appels subséquents pour le même type T ne pouvant pas modifier une constante, se contentent de renvoyer l'id stocké (static)
+             * L'identifiant sert aussi de position dans les signatures d'entités : il doit rester inférieur à MAX_COMPONENTS.
              * 
              * @tparam T 
              * @return size_t 
              */
             template <typename T>
             inline size_t GetComponentTypeID() {
-                static const size_t tid = nextComponentTypeId++;
+                static const size_t tid = nextComponentTypeId.fetch_add(1, std::memory_order_relaxed);
+                if(tid >= MAX_COMPONENTS) throw std::runtime_error("Registry::GetComponentTypeID: too many component types (see MAX_COMPONENTS)");
                 return tid;
             }
 
+            /**
+             * @brief Renvoie la signature qui correspond à un ensemble de types de composants
+             * 
+             * @tparam Ts 
+             * @return Signature 
+             */
+            template<typename... Ts>
+            Signature MakeSignature() {
+                Signature signature;
+                (signature.set(GetComponentTypeID<StorageType<Ts>>()), ...);
+                return signature;
+            }
+
+            /**
+             * @brief Renvoie la signature d'une entité (les types de composants qu'elle possède)
+             * 
+             * @param entityID 
+             * @return Signature 
+             */
+            Signature GetSignature(EntityID entityID) const {
+                return IsValidEntity(entityID) ? mSignatures[EntityIndex(entityID)] : Signature();
+            }
+
+            /**
+             * @brief Remplit le tableau donné avec toutes les entités dont la signature contient le masque donné
+             * 
+             * Parcourt le tableau de signatures de manière linéaire : sur un grand nombre d'entités, ce parcours
+             * (un AND et une comparaison par entité, sur de la mémoire contiguë) peut être vectorisé par le compilateur.
+             * 
+             * @param mask Les composants requis (voir MakeSignature)
+             * @param out Tableau vidé puis rempli avec les entités correspondantes
+             */
+            void GetEntityIDsMatching(const Signature& mask, std::vector<EntityID>& out) const;
+
             /**
              * @brief Renvoie le component référencé par l'EntityID donné
              * 
@@ -294,6 +880,24 @@ namespace Engine::ECS {
                 return (storage->GetMany(entityID));            
             }
 
+            /**
+             * @brief Remplit le tableau donné avec des pointeurs vers tous les composants du type donné présents
+             * 
+             * Variante de GetComponents qui réutilise la mémoire du tableau passé en paramètre (pas d'allocation dans une boucle)
+             * 
+             * @tparam T 
+             * @param entityID 
+             * @param out Tableau vidé puis rempli avec les composants de l'entité
+             */
+            template<typename T>
+            void GetComponents(EntityID entityID, std::vector<T*>& out) {
+                using Base = typename BaseOrSelf<T>::type;
+
+                out.clear();
+                auto* storage = GetStorage<Base>();
+                if(storage) storage->GetMany(entityID, out);
+            }
+
             /**
              * @brief Vérifie si une entité possède un component
              * 
@@ -306,18 +910,29 @@ namespace Engine::ECS {
             bool HasComponent(EntityID entityID) {
                 using Base = typename BaseOrSelf<T>::type;
 
-                auto *storage = GetStorage<Base>();
-                return storage && !!storage->Get(entityID);
+                return IsValidEntity(entityID) && mSignatures[EntityIndex(entityID)].test(GetComponentTypeID<Base>());
             }
 
             // Tags management
             /**
              * @brief Ajoute un tag à une entité
              * 
+             * Le nom est enregistré dans la table globale des tags s'il n'y est pas encore (voir InternTag).
+             * 
              * @param entityID 
              * @param tag 
              */
-            void AddTag(EntityID entityID, std::string tag);
+            void AddTag(EntityID entityID, std::string_view tag);
+            void AddTag(EntityID entityID, TagID tag);
+
+            /**
+             * @brief Retire un tag d'une entité (sans effet si elle ne le possède pas)
+             * 
+             * @param entityID 
+             * @param tag 
+             */
+            void RemoveTag(EntityID entityID, std::string_view tag);
+            void RemoveTag(EntityID entityID, TagID tag);
 
             /**
              * @brief Vérifie si une entité possède un tag
@@ -327,7 +942,16 @@ namespace Engine::ECS {
              * @return true 
              * @return false 
              */
-            bool HasTag(EntityID entityID, std::string tag);
+            bool HasTag(EntityID entityID, std::string_view tag);
+            bool HasTag(EntityID entityID, TagID tag);
+
+            /**
+             * @brief Renvoie les tags d'une entité sous forme de masque (bit i => TagID i)
+             * 
+             * @param entityID 
+             * @return TagMask 
+             */
+            TagMask GetTagMask(EntityID entityID) const;
 
             /**
              * @brief Renvoie les tags associés à une entité donnée
@@ -340,6 +964,8 @@ namespace Engine::ECS {
             /**
              * @brief Ajoute les composants Parent/Children de manière automatique pour créer une relation parent/enfant
              * 
+             * L'enfant est ajouté à la fin de la liste des enfants du parent. S'il avait déjà un parent, il en est d'abord détaché.
+             * 
              * @param parentID 
              * @param childID 
              */
@@ -350,8 +976,110 @@ namespace Engine::ECS {
              * 
              * @param parentID 
              * @param childID 
-             * @param removeComponents Si true => supprime les composants Children/Parent au passage (s'il n'y a pas d'autre enfant)
+             * @param removeComponents Si true => supprime aussi le composant Parent de l'enfant (le composant Children du parent est
+             *                         toujours retiré quand il n'a plus d'enfant)
              */
             void RemoveChild(EntityID parentID, EntityID childID, bool removeComponents = true);
+
+            /**
+             * @brief Renvoie le parent d'une entité
+             * 
+             * @param entityID 
+             * @return EntityID NULL_ENTITY si l'entité n'a pas de parent
+             */
+            EntityID GetParent(EntityID entityID);
+
+            /**
+             * @brief Renvoie le premier enfant d'une entité
+             * 
+             * @param entityID 
+             * @return EntityID NULL_ENTITY si l'entité n'a pas d'enfant
+             */
+            EntityID GetFirstChild(EntityID entityID);
+
+            /**
+             * @brief Renvoie le frère suivant d'une entité, dans la liste des enfants de son parent
+             * 
+             * @param entityID 
+             * @return EntityID NULL_ENTITY pour le dernier enfant (ou une entité sans parent)
+             */
+            EntityID GetNextSibling(EntityID entityID);
+
+            /**
+             * @brief Renvoie le nombre d'enfants directs d'une entité
+             * 
+             * @param entityID 
+             * @return std::size_t 
+             */
+            std::size_t GetChildCount(EntityID entityID);
+
+            /**
+             * @brief Appelle func sur chaque enfant direct d'une entité, dans leur ordre d'ajout
+             * 
+             * func peut retirer ou détruire l'enfant qu'elle reçoit, mais pas modifier le reste de la hiérarchie.
+             * 
+             * @tparam Func Signature attendue : void(EntityID childID)
+             * @param parentID 
+             * @param func 
+             */
+            template<typename Func>
+            void ForEachChild(EntityID parentID, Func&& func) {
+                for(EntityID childID = GetFirstChild(parentID); childID != NULL_ENTITY;) {
+                    EntityID next = GetNextSibling(childID);
+                    func(childID);
+                    childID = next;
+                }
+            }
+
+            /**
+             * @brief Appelle func sur tous les descendants d'une entité (parcours en profondeur, parent avant enfants)
+             * 
+             * Le parcours suit les liens de la hiérarchie sans pile ni allocation. func ne doit pas modifier la hiérarchie.
+             * 
+             * @tparam Func Signature attendue : void(EntityID descendantID)
+             * @param rootID L'entité dont on parcourt les descendants (elle-même n'est pas passée à func)
+             * @param func 
+             */
+            template<typename Func>
+            void ForEachDescendant(EntityID rootID, Func&& func) {
+                EntityID current = GetFirstChild(rootID);
+                while(current != NULL_ENTITY) {
+                    func(current);
+
+                    // Descend si possible, sinon remonte jusqu'au premier ancêtre qui a un frère suivant
+                    EntityID next = GetFirstChild(current);
+                    while(next == NULL_ENTITY && current != rootID) {
+                        next = GetNextSibling(current);
+                        if(next == NULL_ENTITY) current = GetParent(current);
+                    }
+                    current = next;
+                }
+            }
+
+            /**
+             * @brief Détruit une entité et tous ses descendants, en temps linéaire
+             * 
+             * @param rootID 
+             */
+            void DestroySubtree(EntityID rootID);
+
+            /**
+             * @brief Renvoie toutes les entités de la hiérarchie (racines qui ont des enfants, puis leurs descendants), triées par profondeur
+             * 
+             * Un parent est toujours placé avant ses enfants : parcourir la liste dans l'ordre suffit pour propager une valeur
+             * des racines vers les feuilles. La liste est recalculée uniquement quand un lien a changé, au plus tard par FlushCommands.
+             * 
+             * @return const std::vector<EntityID>& 
+             */
+            const std::vector<EntityID>& GetHierarchyOrder();
+
+            /**
+             * @brief Renvoie la version de la hiérarchie, incrémentée à chaque ajout, retrait ou destruction d'un lien
+             * 
+             * Permet de savoir si une valeur calculée à partir des parents (transform monde...) est encore valable.
+             * 
+             * @return std::uint32_t 
+             */
+            std::uint32_t GetHierarchyVersion() const { return mHierarchyVersion; }
     };
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "scheduler.hpp"
+
+#include <algorithm>
+
+namespace Engine::ECS {
+    void SystemScheduler::Add(System* system) {
+        mSystems.push_back(system);
+        mDirty = true;
+    }
+
+    void SystemScheduler::Remove(System* system) {
+        mSystems.erase(std::remove(mSystems.begin(), mSystems.end(), system), mSystems.end());
+        mDirty = true;
+    }
+
+    const std::vector<std::vector<System*>>& SystemScheduler::GetStages() {
+        if(mDirty) BuildStages();
+        return mStages;
+    }
+
+    void SystemScheduler::BuildStages() {
+        mStages.clear();
+        std::vector<std::size_t> stageOf(mSystems.size(), 0);
+
+        for(std::size_t i = 0; i < mSystems.size(); ++i) {
+            // Le système passe après tous les systèmes enregistrés avant lui avec lesquels il est en conflit
+            std::size_t stage = 0;
+            for(std::size_t j = 0; j < i; ++j) {
+                if(mSystems[i]->ConflictsWith(*mSystems[j])) stage = std::max(stage, stageOf[j] + 1);
+            }
+
+            stageOf[i] = stage;
+            if(stage >= mStages.size()) mStages.resize(stage + 1);
+            mStages[stage].push_back(mSystems[i]);
+        }
+
+        mDirty = false;
+    }
+
+    void SystemScheduler::Execute(System* system) {
+        // Le système lit les changements faits depuis sa dernière exécution de cette phase (pas de la phase précédente)
+        ChangeTick& phaseTick = system->mPhaseTicks[static_cast<size_t>(mPhase)];
+        system->mLastRunTick = phaseTick;
+
+        switch(mPhase) {
+            case SystemPhase::FixedUpdate: system->OnFixedUpdate(mDeltaTime); break;
+            case SystemPhase::Update: system->OnUpdate(mDeltaTime); break;
+            case SystemPhase::PreRender: system->OnPreRender(mDeltaTime); break;
+            case SystemPhase::LateUpdate: system->OnLateUpdate(mDeltaTime); break;
+        }
+
+        if(system->mRegistry) phaseTick = system->mRegistry->AdvanceChangeTick();
+    }
+
+    void SystemScheduler::Run(SystemPhase phase, float deltaTime, bool parallel) {
+        mPhase = phase;
+        mDeltaTime = deltaTime;
+
+        for(const auto& stage : GetStages()) {
+            mBatch.clear();
+            for(System* system : stage) {
+                if(phase == SystemPhase::FixedUpdate || !system->IsPaused()) mBatch.push_back(system);
+            }
+
+            if(!parallel || mJobs.GetWorkerCount() == 0 || mBatch.size() < 2) {
+                for(System* system : mBatch) Execute(system);
+            } else {
+                RunBatch();
+            }
+        }
+    }
+
+    void SystemScheduler::RunBatch() {
+        // Un système par tâche : le thread principal exécute le premier, puis aide les threads de travail
+        mJobs.ParallelFor(mBatch.size(), 1, [this](std::size_t begin, std::size_t end) {
+            for(std::size_t i = begin; i < end; ++i) Execute(mBatch[i]);
+        });
+    }
+}
@@ -0,0 +1,108 @@
+/**
+ * @file scheduler.hpp
+ * @brief Définit l'ordonnanceur des systèmes : exécute en parallèle les systèmes qui n'accèdent pas aux mêmes composants
+ * 
+ * Les systèmes sont rangés en "étapes", dans leur ordre d'enregistrement : un système est placé juste après la dernière
+ * étape qui contient un système avec lequel il est en conflit (voir System::ConflictsWith). Les systèmes d'une même étape
+ * sont indépendants, ils peuvent donc être exécutés en même temps. Les étapes, elles, sont exécutées l'une après l'autre.
+ * 
+ * L'ordre relatif de deux systèmes en conflit est toujours celui de leur enregistrement : l'exécution sur un seul thread
+ * produit exactement le même résultat que l'exécution parallèle.
+ */
+#pragma once
+
+#include <vector>
+
+#include "system.hpp"
+#include "../core/jobsystem.hpp"
+
+namespace Engine::ECS {
+    /**
+     * @brief Ordonnanceur des systèmes d'une application
+     * 
+     */
+    class SystemScheduler {
+        private:
+            /** @brief Les systèmes, dans leur ordre d'enregistrement */
+            std::vector<System*> mSystems;
+            /** @brief Les étapes d'exécution (systèmes sans conflit entre eux, dans l'ordre d'enregistrement) */
+            std::vector<std::vector<System*>> mStages;
+            /** @brief Vrai si les étapes doivent être recalculées (système ajouté ou retiré) */
+            bool mDirty = true;
+            /** @brief Les systèmes actifs de l'étape en cours, réutilisé d'une étape à l'autre */
+            std::vector<System*> mBatch;
+
+            /** @brief Le système de tâches qui exécute les étapes en parallèle */
+            Core::JobSystem& mJobs;
+            SystemPhase mPhase = SystemPhase::Update;
+            float mDeltaTime = 0.0f;
+
+            /**
+             * @brief Range les systèmes en étapes
+             * 
+             */
+            void BuildStages();
+
+            /**
+             * @brief Appelle le callback de la phase courante sur un système
+             * 
+             * @param system
+             */
+            void Execute(System* system);
+
+            /**
+             * @brief Exécute les systèmes de mBatch en parallèle, et attend qu'ils soient tous terminés
+             * 
+             */
+            void RunBatch();
+
+        public:
+            /**
+             * @brief Construit l'ordonnanceur
+             * 
+             * @param jobs Le système de tâches utilisé pour exécuter les systèmes en parallèle
+             */
+            explicit SystemScheduler(Core::JobSystem& jobs) : mJobs(jobs) {}
+            SystemScheduler(const SystemScheduler&) = delete;
+            SystemScheduler& operator=(const SystemScheduler&) = delete;
+
+            /**
+             * @brief Ajoute un système à la fin de l'ordre d'enregistrement
+             * 
+             * @param system
+             */
+            void Add(System* system);
+
+            /**
+             * @brief Retire un système de l'ordonnanceur
+             * 
+             * @param system
+             */
+            void Remove(System* system);
+
+            /**
+             * @brief Renvoie les systèmes dans leur ordre d'enregistrement
+             * 
+             * @return const std::vector<System*>&
+             */
+            const std::vector<System*>& GetSystems() const { return mSystems; }
+
+            /**
+             * @brief Renvoie les étapes d'exécution des systèmes
+             * 
+             * @return const std::vector<std::vector<System*>>&
+             */
+            const std::vector<std::vector<System*>>& GetStages();
+
+            /**
+             * @brief Exécute une phase sur tous les systèmes, étape par étape
+             * 
+             * Les systèmes en pause sont ignorés, sauf pendant la phase FixedUpdate.
+             * 
+             * @param phase
+             * @param deltaTime
+             * @param parallel Si false, tous les systèmes sont exécutés sur le thread appelant (même ordre, même résultat)
+             */
+            void Run(SystemPhase phase, float deltaTime, bool parallel = true);
+    };
+}
@@ -0,0 +1,166 @@
+#include "snapshot.hpp"
+#include "hierarchy.hpp"
+#include "commandbuffer.hpp"
+
+namespace Engine::ECS {
+    namespace {
+        /** @brief Signature d'un snapshot ("OGLS") */
+        constexpr std::uint32_t SNAPSHOT_MAGIC = 0x534C474F;
+        /** @brief Version du format, à incrémenter à chaque changement de structure */
+        constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+
+        static_assert(MAX_TAGS <= 64, "Snapshot: tag masks are saved as 64-bit integers");
+    }
+
+    std::vector<Snapshot::ComponentType>& Snapshot::Types() {
+        // La hiérarchie fait toujours partie du snapshot : ses liens sont des EntityID, restaurés à l'identique
+        static std::vector<ComponentType> types = {
+            {"Parent", sizeof(Parent), &SaveStorage<Parent>, &LoadStorage<Parent>},
+            {"Children", sizeof(Children), &SaveStorage<Children>, &LoadStorage<Children>}
+        };
+        return types;
+    }
+
+    void Snapshot::Save(Registry& registry, std::vector<std::byte>& out) {
+        Write(out, SNAPSHOT_MAGIC);
+        Write(out, SNAPSHOT_VERSION);
+
+        // Entités : identifiants de tous les index (vivants ou libres), puis la pile des index libres
+        std::uint32_t capacity = static_cast<std::uint32_t>(registry.mEntityHandles.Size());
+        Write(out, capacity);
+        for(std::uint32_t i = 0; i < capacity; ++i) Write(out, registry.mEntityHandles[i]);
+
+        Write(out, static_cast<std::uint32_t>(registry.mFreeIndices.size()));
+        Write(out, registry.mFreeIndices.data(), registry.mFreeIndices.size() * sizeof(std::uint32_t));
+
+        // Tags : les TagID dépendent de l'ordre d'interning, on sauvegarde donc aussi leurs noms
+        std::uint32_t tagCount = 0;
+        for(const ECS::Group& tagEntities : registry.mTagIndex) tagCount += tagEntities.GetEntities().empty() ? 0 : 1;
+        Write(out, tagCount);
+        for(TagID tag = 0; tag < registry.mTagIndex.size(); ++tag) {
+            if(registry.mTagIndex[tag].GetEntities().empty()) continue;
+
+            std::string_view name = GetTagName(tag);
+            Write(out, tag);
+            Write(out, static_cast<std::uint32_t>(name.size()));
+            Write(out, name.data(), name.size());
+        }
+
+        std::uint32_t taggedCount = 0;
+        for(std::uint32_t i = 0; i < capacity; ++i) taggedCount += registry.mTagMasks[i].any() ? 1 : 0;
+        Write(out, taggedCount);
+        for(std::uint32_t i = 0; i < capacity; ++i) {
+            if(registry.mTagMasks[i].none()) continue;
+
+            Write(out, i);
+            Write(out, static_cast<std::uint64_t>(registry.mTagMasks[i].to_ullong()));
+        }
+
+        // Composants : un bloc par type enregistré
+        std::uint32_t typeCount = static_cast<std::uint32_t>(Types().size());
+        Write(out, typeCount);
+        for(const ComponentType& type : Types()) {
+            Write(out, static_cast<std::uint32_t>(type.name.size()));
+            Write(out, type.name.data(), type.name.size());
+            Write(out, static_cast<std::uint32_t>(type.size));
+            type.save(registry, out);
+        }
+    }
+
+    void Snapshot::Load(Registry& registry, const std::byte* data, std::size_t size) {
+        Reader in{data, size};
+        if(in.Read<std::uint32_t>() != SNAPSHOT_MAGIC) throw std::runtime_error("Snapshot::Load: not a registry snapshot");
+        if(in.Read<std::uint32_t>() != SNAPSHOT_VERSION) throw std::runtime_error("Snapshot::Load: unsupported snapshot version");
+
+        std::uint32_t capacity = in.Read<std::uint32_t>();
+        if(capacity > MAX_ENTITIES) throw std::runtime_error("Snapshot::Load: entity capacity exceeded");
+
+        // Les commandes en attente visent l'état courant, qui va disparaître
+        registry.mCommandBuffer->Clear();
+
+        // Destruction par DestroyEntity plutôt que Clear : les observateurs OnRemove restent branchés et sont prévenus
+        std::size_t currentCapacity = registry.mEntityHandles.Size();
+        for(std::size_t i = 0; i < currentCapacity; ++i) {
+            EntityID entityID = registry.mEntityHandles[i];
+            if(EntityIndex(entityID) == i) registry.DestroyEntity(entityID);
+        }
+
+        // Entités : mêmes identifiants et mêmes générations que dans le registre sauvegardé
+        registry.mEntityHandles.Reserve(capacity);
+        registry.mSignatures.Reserve(capacity);
+        registry.mTagMasks.Reserve(capacity);
+        for(std::uint32_t i = 0; i < capacity; ++i) {
+            EntityID entityID = in.Read<EntityID>();
+            std::uint32_t entityIndex = EntityIndex(entityID);
+            if(entityIndex != i && entityIndex != ENTITY_INDEX_MASK) throw std::runtime_error("Snapshot::Load: corrupted entity table");
+
+            if(i < registry.mEntityHandles.Size()) {
+                registry.mEntityHandles[i] = entityID;
+            } else {
+                registry.mSignatures.PushBack(Signature());
+                registry.mTagMasks.PushBack(TagMask());
+                registry.mEntityHandles.PushBack(entityID);
+            }
+        }
+
+        // Les index au-delà de la capacité sauvegardée restent libres, distribués après ceux du snapshot
+        registry.mFreeIndices.clear();
+        for(std::uint32_t i = static_cast<std::uint32_t>(registry.mEntityHandles.Size()); i-- > capacity;) registry.mFreeIndices.push_back(i);
+
+        std::uint32_t freeCount = in.Read<std::uint32_t>();
+        const std::byte* freeIndices = in.Take(std::size_t(freeCount) * sizeof(std::uint32_t));
+        std::size_t freeOffset = registry.mFreeIndices.size();
+        registry.mFreeIndices.resize(freeOffset + freeCount);
+        if(freeCount) std::memcpy(registry.mFreeIndices.data() + freeOffset, freeIndices, std::size_t(freeCount) * sizeof(std::uint32_t));
+
+        // Tags : les TagID sauvegardés sont remappés sur ceux de ce programme
+        std::uint32_t tagCount = in.Read<std::uint32_t>();
+        std::vector<TagID> tagRemap(MAX_TAGS, INVALID_TAG);
+        for(std::uint32_t i = 0; i < tagCount; ++i) {
+            TagID savedTag = in.Read<TagID>();
+            std::uint32_t length = in.Read<std::uint32_t>();
+            const char* name = reinterpret_cast<const char*>(in.Take(length));
+            if(savedTag >= MAX_TAGS) throw std::runtime_error("Snapshot::Load: corrupted tag table");
+
+            tagRemap[savedTag] = InternTag(std::string_view(name, length));
+        }
+
+        std::uint32_t taggedCount = in.Read<std::uint32_t>();
+        for(std::uint32_t i = 0; i < taggedCount; ++i) {
+            std::uint32_t entityIndex = in.Read<std::uint32_t>();
+            TagMask mask(in.Read<std::uint64_t>());
+            if(entityIndex >= capacity) throw std::runtime_error("Snapshot::Load: corrupted tag table");
+
+            EntityID entityID = registry.mEntityHandles[entityIndex];
+            for(TagID tag = 0; tag < MAX_TAGS; ++tag) {
+                if(!mask.test(tag)) continue;
+                if(tagRemap[tag] == INVALID_TAG) throw std::runtime_error("Snapshot::Load: corrupted tag table");
+                registry.AddTag(entityID, tagRemap[tag]);
+            }
+        }
+
+        // Composants : les types inconnus (ou de taille différente) ne peuvent pas être relus
+        std::uint32_t typeCount = in.Read<std::uint32_t>();
+        for(std::uint32_t i = 0; i < typeCount; ++i) {
+            std::uint32_t length = in.Read<std::uint32_t>();
+            std::string_view name(reinterpret_cast<const char*>(in.Take(length)), length);
+            std::uint32_t componentSize = in.Read<std::uint32_t>();
+            std::uint32_t count = in.Read<std::uint32_t>();
+
+            const ComponentType* type = nullptr;
+            for(const ComponentType& registered : Types()) {
+                if(registered.name == name) type = &registered;
+            }
+
+            if(!type) {
+                in.Take(std::size_t(count) * (sizeof(EntityID) + componentSize));
+                continue;
+            }
+            if(type->size != componentSize) throw std::runtime_error("Snapshot::Load: component layout mismatch for " + type->name);
+
+            type->load(registry, in, count);
+        }
+
+        registry.HierarchyChanged();
+    }
+}
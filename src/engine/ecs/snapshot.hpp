@@ -0,0 +1,221 @@
+/**
+ * @file snapshot.hpp
+ * @brief Sauvegarde et restauration binaire d'un registre complet (chargement rapide, sauvegarde rapide, rollback)
+ * 
+ * Un snapshot contient les identifiants d'entités (générations et index libres compris), les tags, et les composants
+ * des types enregistrés avec Snapshot::RegisterComponent. Ces composants doivent être trivialement copiables :
+ * chaque stockage est copié d'un bloc, page par page. La hiérarchie (composants Parent et Children) en fait toujours partie.
+ * 
+ * Les types sont identifiés par leur nom (les identifiants de types de composants dépendent de l'ordre d'exécution),
+ * un snapshot peut donc être écrit sur disque et relu par une autre exécution du même programme.
+ * 
+ * Utilisation :
+ *   ECS::Snapshot::RegisterComponent<MyComponent>("MyComponent");
+ *   std::vector<std::byte> blob;
+ *   ECS::Snapshot::Save(registry, blob);
+ *   ...
+ *   ECS::Snapshot::Load(registry, blob);
+ */
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <new>
+
+#include "registry.hpp"
+
+namespace Engine::ECS {
+    /**
+     * @brief Sauvegarde et restauration binaire d'un registre
+     * 
+     */
+    class Snapshot {
+        public:
+            /**
+             * @brief Lecture bornée d'un snapshot (lève une exception si le snapshot est tronqué)
+             * 
+             */
+            struct Reader {
+                const std::byte* data;
+                std::size_t size;
+                std::size_t offset = 0;
+
+                /**
+                 * @brief Renvoie l'adresse des count octets suivants, et avance d'autant
+                 * 
+                 * @param count
+                 * @return const std::byte*
+                 */
+                const std::byte* Take(std::size_t count) {
+                    if(count > size - offset) throw std::runtime_error("Snapshot::Load: truncated snapshot");
+                    const std::byte* current = data + offset;
+                    offset += count;
+                    return current;
+                }
+
+                template<typename V>
+                V Read() {
+                    V value;
+                    std::memcpy(&value, Take(sizeof(V)), sizeof(V));
+                    return value;
+                }
+            };
+
+        private:
+            /** @brief Un type de composant enregistré, avec ses fonctions de sauvegarde et de restauration */
+            struct ComponentType {
+                std::string name;
+                std::size_t size;
+                std::function<void(Registry&, std::vector<std::byte>&)> save;
+                std::function<void(Registry&, Reader&, std::size_t)> load;
+            };
+
+            /**
+             * @brief Renvoie la table globale des types de composants enregistrés
+             * 
+             * @return std::vector<ComponentType>&
+             */
+            static std::vector<ComponentType>& Types();
+
+            /**
+             * @brief Ajoute size octets à la fin du snapshot
+             * 
+             * @param out
+             * @param data
+             * @param size
+             */
+            static void Write(std::vector<std::byte>& out, const void* data, std::size_t size) {
+                std::size_t offset = out.size();
+                out.resize(offset + size);
+                if(size) std::memcpy(out.data() + offset, data, size);
+            }
+
+            template<typename V>
+            static void Write(std::vector<std::byte>& out, const V& value) {
+                Write(out, &value, sizeof(V));
+            }
+
+            /**
+             * @brief Sauvegarde le stockage de T : nombre de composants, entités, puis les composants d'un bloc
+             * 
+             * @tparam T
+             * @param registry
+             * @param out
+             */
+            template<typename T>
+            static void SaveStorage(Registry& registry, std::vector<std::byte>& out) {
+                ComponentStorage<T>* storage = registry.GetStorage<T>();
+                std::uint32_t count = storage ? static_cast<std::uint32_t>(storage->Size()) : 0;
+                Write(out, count);
+                if(!count) return;
+
+                Write(out, storage->GetEntities().data(), count * sizeof(EntityID));
+
+                std::size_t offset = out.size();
+                out.resize(offset + count * sizeof(T));
+                storage->CopyTo(out.data() + offset);
+            }
+
+            /**
+             * @brief Restaure les composants de T lus dans le snapshot (les entités doivent déjà être restaurées)
+             * 
+             * @tparam T
+             * @param registry
+             * @param in
+             * @param count
+             */
+            template<typename T>
+            static void LoadStorage(Registry& registry, Reader& in, std::size_t count) {
+                const EntityID* entities = reinterpret_cast<const EntityID*>(in.Take(count * sizeof(EntityID)));
+                const std::byte* components = in.Take(count * sizeof(T));
+
+                // Les entités sont relues par memcpy : le snapshot n'est pas forcément aligné
+                std::vector<EntityID> ids(count);
+                std::memcpy(ids.data(), entities, count * sizeof(EntityID));
+                for(EntityID entityID : ids) {
+                    if(!registry.IsValidEntity(entityID)) throw std::runtime_error("Snapshot::Load: component attached to a dead entity");
+                }
+
+                ComponentStorage<T>* storage = registry.GetOrCreateStorage<T>();
+
+                if(storage->IsExternal()) {
+                    // Backend archétype : chaque composant rejoint le chunk de son entité
+                    for(std::size_t i = 0; i < count; ++i) {
+                        alignas(T) std::byte buffer[sizeof(T)];
+                        std::memcpy(buffer, components + i * sizeof(T), sizeof(T));
+                        registry.AddComponent<T>(ids[i], *std::launder(reinterpret_cast<T*>(buffer)));
+                    }
+                    return;
+                }
+
+                std::size_t first = storage->Size();
+                storage->AppendRaw(ids.data(), components, count);
+
+                Signature mask = registry.MakeSignature<T>();
+                for(std::size_t i = 0; i < count; ++i) {
+                    T& component = storage->GetAt(first + i);
+                    if constexpr (std::is_base_of_v<Component, T>) component.SetOwner(ids[i], &registry);
+
+                    registry.SetSignature(ids[i], registry.mSignatures[EntityIndex(ids[i])] | mask);
+                    storage->NotifyAdded(ids[i], component);
+                }
+            }
+
+        public:
+            /**
+             * @brief Enregistre un type de composant à inclure dans les snapshots
+             * 
+             * Enregistrer à nouveau un nom déjà connu remplace l'ancien type.
+             * 
+             * @tparam T Un composant non polymorphique et trivialement copiable
+             * @param name Nom stable du type, écrit dans le snapshot
+             */
+            template<typename T>
+            static void RegisterComponent(std::string_view name) {
+                static_assert(ComponentStorage<T>::IsPacked, "Snapshot::RegisterComponent: polymorphic components can not be saved");
+                static_assert(std::is_trivially_copyable_v<T>, "Snapshot::RegisterComponent: T must be trivially copyable");
+
+                ComponentType type{std::string(name), sizeof(T), &SaveStorage<T>, &LoadStorage<T>};
+                for(ComponentType& existing : Types()) {
+                    if(existing.name == name) {
+                        existing = std::move(type);
+                        return;
+                    }
+                }
+                Types().push_back(std::move(type));
+            }
+
+            /**
+             * @brief Ecrit l'état complet du registre à la fin de out
+             * 
+             * Les commandes en attente dans le CommandBuffer ne font pas partie du snapshot.
+             * 
+             * @param registry
+             * @param out
+             */
+            static void Save(Registry& registry, std::vector<std::byte>& out);
+
+            /**
+             * @brief Remplace l'état du registre par celui d'un snapshot
+             * 
+             * Toutes les entités actuelles sont détruites (les observateurs OnRemove sont appelés), puis les entités du snapshot
+             * sont recréées avec leurs identifiants d'origine. Les commandes en attente dans le CommandBuffer sont abandonnées.
+             * Les composants de types non enregistrés dans ce programme sont ignorés.
+             * 
+             * @param registry
+             * @param data
+             * @param size
+             */
+            static void Load(Registry& registry, const std::byte* data, std::size_t size);
+
+            static void Load(Registry& registry, const std::vector<std::byte>& snapshot) {
+                Load(registry, snapshot.data(), snapshot.size());
+            }
+    };
+}
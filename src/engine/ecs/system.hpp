@@ -8,7 +8,9 @@
 #pragma once
 
 #include "../constants.hpp"
+#include <algorithm>
 #include <set>
+#include <typeindex>
 
 #include "registry.hpp"
 
@@ -17,6 +19,22 @@ namespace Engine {
 }
 
 namespace Engine::ECS {
+    /**
+     * @brief Les phases de la boucle principale prises en charge par l'ordonnanceur
+     * 
+     * Les phases de rendu (OnRender, OnUIRender) restent sur le thread principal, qui possède le contexte OpenGL.
+     */
+    enum class SystemPhase {
+        FixedUpdate,
+        Update,
+        /** @brief Après l'update et son point de synchronisation, juste avant le rendu */
+        PreRender,
+        LateUpdate
+    };
+
+    /** @brief Nombre de phases dans SystemPhase */
+    constexpr size_t SYSTEM_PHASE_COUNT = 4;
+
     /**
      * @brief La classe System implémente une logique spécifique à des composants
      * 
@@ -24,6 +42,8 @@ namespace Engine::ECS {
     class System {
         // On veut que App puisse accéder aux champs private du System
         friend class Engine::App;
+        // L'ordonnanceur date chaque exécution du système (voir GetLastRunTick)
+        friend class SystemScheduler;
 
         private:
             /**
@@ -34,7 +54,7 @@ namespace Engine::ECS {
              * 
              * La classe App s'occupe de faire pointer vers un nouveau registre en cas de changement de scène pendant l'éxecution.
              */
-            Registry* mRegistry;
+            Registry* mRegistry = nullptr;
             /**
              * @brief Pointeur vers l'objet App principal
              * 
@@ -44,6 +64,43 @@ namespace Engine::ECS {
             /** @brief Permet de mettre en pause un système complètement. La classe App ignore les systèmes en pause */
             bool mPaused = false;
 
+            /** @brief Valeur du compteur de changements du registre à la fin de la dernière exécution de la phase en cours */
+            ChangeTick mLastRunTick = 0;
+            /** @brief Valeur du compteur de changements du registre à la fin de la dernière exécution de chaque phase */
+            ChangeTick mPhaseTicks[SYSTEM_PHASE_COUNT] = {};
+
+            /** @brief Les types de composants lus par le système (voir Reads) */
+            std::set<std::type_index> mReads;
+            /** @brief Les types de composants modifiés par le système (voir Writes) */
+            std::set<std::type_index> mWrites;
+
+        protected:
+            /**
+             * @brief Déclare les types de composants que le système lit pendant ses updates
+             * 
+             * À appeler dans le constructeur du système. Deux systèmes qui ne font que lire les mêmes composants
+             * peuvent être exécutés en même temps par le SystemScheduler.
+             * 
+             * @tparam Ts 
+             */
+            template<typename... Ts>
+            void Reads() {
+                (mReads.insert(std::type_index(typeid(StorageType<Ts>))), ...);
+            }
+
+            /**
+             * @brief Déclare les types de composants que le système modifie pendant ses updates
+             * 
+             * À appeler dans le constructeur du système. Un système qui déclare ses accès ne doit faire aucun
+             * changement structurel directement sur le registre : il passe par le tampon de commandes (Registry::GetCommandBuffer).
+             * 
+             * @tparam Ts 
+             */
+            template<typename... Ts>
+            void Writes() {
+                (mWrites.insert(std::type_index(typeid(StorageType<Ts>))), ...);
+            }
+
         public:
             /**
              * @brief Renvoie le registre actif
@@ -58,6 +115,33 @@ namespace Engine::ECS {
              */
             Engine::App& GetApp() { return *mApp; }
 
+            /**
+             * @brief Renvoie la date de la dernière exécution de la phase en cours par le système (0 s'il ne l'a pas encore exécutée sur ce registre)
+             * 
+             * Chaque phase a sa propre date : dans OnUpdate, c'est la fin de l'update précédente. Les composants modifiés depuis,
+             * dans les autres phases comme dans les hooks de la scène, ont un tick strictement supérieur :
+             * GetRegistry().IsChanged<T>(id, GetLastRunTick()), GetRegistry().ForEachChanged<T>(GetLastRunTick(), ...), etc.
+             * Les changements faits par le système lui-même pendant son exécution ne sont pas vus à l'exécution suivante.
+             * 
+             * @return ChangeTick 
+             */
+            ChangeTick GetLastRunTick() const { return mLastRunTick; }
+
+            /**
+             * @brief Renvoie la date jusqu'à laquelle le système a lu les évènements de composants
+             * 
+             * La classe App oublie à chaque frame les évènements antérieurs à la plus petite de ces dates (voir Registry::TrimEvents).
+             * Par défaut, c'est la plus ancienne des dernières exécutions de ses phases. Un système qui lit les évènements
+             * depuis une date à lui (et pas depuis GetLastRunTick) doit la prendre en compte en surchargeant cette fonction.
+             * 
+             * @return ChangeTick 
+             */
+            virtual ChangeTick GetConsumedTick() const {
+                ChangeTick tick = mPhaseTicks[0];
+                for(ChangeTick phaseTick : mPhaseTicks) tick = std::min(tick, phaseTick);
+                return tick;
+            }
+
             /** @brief Passe le booléen "mPaused" a false */
             void Resume() { mPaused = false; }
             /** @brief Passe le booléen "mPaused" a true */
@@ -70,6 +154,39 @@ namespace Engine::ECS {
              */
             bool IsPaused() { return mPaused; }
 
+            /**
+             * @brief Vérifie si le système a déclaré les composants auxquels il accède (voir Reads/Writes)
+             * 
+             * Un système qui ne déclare rien (ou qui appelle des scripts, qui peuvent accéder à tout) est exclusif :
+             * il n'est jamais exécuté en même temps qu'un autre système.
+             * 
+             * @return true 
+             * @return false 
+             */
+            bool DeclaresAccess() const { return !mReads.empty() || !mWrites.empty(); }
+
+            /**
+             * @brief Vérifie si deux systèmes ne peuvent pas être exécutés en même temps
+             * 
+             * C'est le cas si l'un des deux est exclusif, ou si l'un modifie un type de composant que l'autre lit ou modifie.
+             * 
+             * @param other 
+             * @return true 
+             * @return false 
+             */
+            bool ConflictsWith(const System& other) const {
+                if(!DeclaresAccess() || !other.DeclaresAccess()) return true;
+
+                for(const auto& type : mWrites) {
+                    if(other.mReads.count(type) || other.mWrites.count(type)) return true;
+                }
+                for(const auto& type : other.mWrites) {
+                    if(mReads.count(type)) return true;
+                }
+
+                return false;
+            }
+
             virtual ~System() = default;
 
             /**
@@ -95,6 +212,14 @@ namespace Engine::ECS {
              * @param deltaTime Le temps écoulé depuis la frame précédente
              */
             virtual void OnUpdate(float deltaTime) {}
+            /**
+             * @brief Fonction appelée juste avant le rendu, une fois l'update terminée et les changements structurels appliqués
+             * 
+             * Sert à préparer les données lues par les systèmes de rendu (par exemple le cache des transforms monde).
+             * 
+             * @param deltaTime Le temps écoulé depuis la frame précédente
+             */
+            virtual void OnPreRender(float deltaTime) {}
             /**
              * @brief Fonction appelée au rendu à l'écran
              * 
@@ -0,0 +1,54 @@
+#include "tag.hpp"
+
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <stdexcept>
+
+namespace Engine::ECS {
+    namespace {
+        /** @brief Hash transparent : permet de chercher un std::string_view sans construire de std::string */
+        struct TagNameHash {
+            using is_transparent = void;
+            std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>()(name); }
+        };
+
+        /** @brief Les noms de tags, indexés par TagID (deque : les références renvoyées par GetTagName restent valides) */
+        std::deque<std::string> gTagNames;
+        std::unordered_map<std::string, TagID, TagNameHash, std::equal_to<>> gTagIDs;
+        /** @brief Les systèmes peuvent chercher des tags depuis plusieurs threads (voir SystemScheduler) */
+        std::shared_mutex gTagMutex;
+    }
+
+    TagID InternTag(std::string_view name) {
+        {
+            std::shared_lock lock(gTagMutex);
+            auto it = gTagIDs.find(name);
+            if(it != gTagIDs.end()) return it->second;
+        }
+
+        std::unique_lock lock(gTagMutex);
+        auto it = gTagIDs.find(name);
+        if(it != gTagIDs.end()) return it->second;
+
+        if(gTagNames.size() >= MAX_TAGS) throw std::runtime_error("InternTag: too many different tags (MAX_TAGS = " + std::to_string(MAX_TAGS) + ")");
+
+        TagID tagID = static_cast<TagID>(gTagNames.size());
+        gTagNames.emplace_back(name);
+        gTagIDs.emplace(gTagNames.back(), tagID);
+        return tagID;
+    }
+
+    TagID FindTag(std::string_view name) {
+        std::shared_lock lock(gTagMutex);
+        auto it = gTagIDs.find(name);
+        return it != gTagIDs.end() ? it->second : INVALID_TAG;
+    }
+
+    const std::string& GetTagName(TagID tagID) {
+        std::shared_lock lock(gTagMutex);
+        if(tagID >= gTagNames.size()) throw std::runtime_error("GetTagName: unknown tag ID " + std::to_string(tagID));
+        return gTagNames[tagID];
+    }
+}
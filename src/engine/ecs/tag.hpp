@@ -0,0 +1,48 @@
+/**
+ * @file tag.hpp
+ * @brief Définit l'interning des tags : chaque nom de tag est associé une fois pour toutes à un petit identifiant entier
+ * 
+ * La table est globale (partagée par tous les registres) : un même nom a le même TagID dans toutes les scènes.
+ * Les registres ne manipulent ensuite que des TagID, rangés dans un TagMask par entité.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <limits>
+
+#include "../constants.hpp"
+
+namespace Engine::ECS {
+    /** @brief Identifiant d'un tag, indexe les bits d'un TagMask */
+    using TagID = std::uint32_t;
+    /** @brief Identifiant qui ne désigne aucun tag */
+    constexpr TagID INVALID_TAG = std::numeric_limits<TagID>::max();
+
+    /**
+     * @brief Renvoie l'identifiant d'un tag, en l'enregistrant s'il n'existe pas encore
+     * 
+     * Lève une exception si plus de MAX_TAGS tags différents sont enregistrés.
+     * 
+     * @param name 
+     * @return TagID 
+     */
+    TagID InternTag(std::string_view name);
+
+    /**
+     * @brief Renvoie l'identifiant d'un tag déjà enregistré, sans rien enregistrer
+     * 
+     * @param name 
+     * @return TagID INVALID_TAG si aucun tag de ce nom n'a jamais été enregistré
+     */
+    TagID FindTag(std::string_view name);
+
+    /**
+     * @brief Renvoie le nom d'un tag enregistré
+     * 
+     * @param tagID 
+     * @return const std::string& 
+     */
+    const std::string& GetTagName(TagID tagID);
+}
@@ -0,0 +1,290 @@
+/**
+ * @file view.hpp
+ * @brief Définit une vue ECS : un parcours paresseux des entités qui possèdent un ensemble de composants
+ * 
+ * Contrairement à Registry::GetEntityIDsWith, une vue n'alloue rien : elle parcourt directement le tableau dense
+ * du plus petit stockage concerné, et renvoie pour chaque entité valide un tuple (EntityID, Ts&...).
+ * 
+ * Avec le backend StorageBackend::Archetype, une vue sur des composants compacts parcourt plutôt les chunks
+ * des archétypes qui contiennent tous les types demandés, ligne par ligne.
+ */
+#pragma once
+
+#include <tuple>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+#include "../defs.hpp"
+#include "componentstorage.hpp"
+#include "archetype.hpp"
+#include "pagedarray.hpp"
+
+namespace Engine::ECS {
+    /**
+     * @brief Vue sur les entités qui possèdent tous les composants Ts...
+     * 
+     * Utilisation : for(auto [entityID, transform, sprite] : registry.View<Transform, Sprite>()) { ... }
+     * 
+     * Le parcours se fait du dernier élément du stockage vers le premier : détruire l'entité courante (ou lui retirer
+     * un composant) pendant le parcours est donc sans danger. Les entités créées pendant le parcours ne sont pas visitées.
+     * 
+     * @tparam Ts Les types de composants demandés (un type "const T" donne un accès en lecture seule)
+     */
+    template<typename... Ts>
+    class View {
+        static_assert(sizeof...(Ts) > 0, "View: at least one component type is required");
+        static_assert((std::is_same_v<std::remove_const_t<Ts>, StorageType<Ts>> && ...), "View: components must be requested through their BaseType");
+
+        /** @brief Vrai si tous les types demandés peuvent être rangés dans des archétypes */
+        static constexpr bool AllPacked = (ComponentStorage<StorageType<Ts>>::IsPacked && ...);
+        /** @brief Valeur utilisée pour "commencer par la fin" d'un archétype ou d'un chunk */
+        static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);
+
+        private:
+            /** @brief Pointeurs vers les stockages de chaque type demandé (nullptr si le stockage n'existe pas) */
+            std::tuple<ComponentStorage<StorageType<Ts>>*...> mStorages;
+            /** @brief Le tableau dense d'entités du plus petit stockage, qui dirige le parcours */
+            const std::vector<EntityID>* mDriver = nullptr;
+            /** @brief Les signatures des entités du registre, indexées par EntityIndex */
+            const PagedArray<Signature>* mSignatures = nullptr;
+            /** @brief La signature des types demandés */
+            Signature mMask;
+            /** @brief Les archétypes du registre (nullptr => parcours des stockages) */
+            const std::vector<Archetype*>* mArchetypes = nullptr;
+            /** @brief Les identifiants de types demandés, pour retrouver les colonnes des archétypes */
+            std::array<std::size_t, sizeof...(Ts)> mTypeIDs{};
+
+            /**
+             * @brief Vérifie si un archétype non vide contient tous les types demandés, et renvoie leurs colonnes
+             * 
+             * @param archetype
+             * @param columns
+             * @return true
+             * @return false
+             */
+            bool Matches(const Archetype& archetype, std::array<int, sizeof...(Ts)>& columns) const {
+                for(std::size_t i = 0; i < sizeof...(Ts); ++i) {
+                    columns[i] = archetype.ColumnOf(mTypeIDs[i]);
+                    if(columns[i] < 0) return false;
+                }
+
+                return archetype.Size() > 0;
+            }
+
+        public:
+            /** @brief Elément renvoyé à chaque itération */
+            using value_type = std::tuple<EntityID, Ts&...>;
+
+            /**
+             * @brief Itérateur de la vue
+             * 
+             * Il garde en cache les pointeurs vers les composants de l'entité courante, calculés pendant le filtrage :
+             * aucun accès supplémentaire aux stockages n'est fait au moment de lire l'élément.
+             */
+            class Iterator {
+                private:
+                    const View* mView;
+                    /** @brief Archétype courant + 1 (mode archétype uniquement, 0 => fin du parcours) */
+                    std::size_t mArchetype = 0;
+                    /** @brief Chunk courant de l'archétype (mode archétype uniquement) */
+                    std::size_t mChunk = 0;
+                    /** @brief Position de l'élément courant + 1 : dans le tableau dense, ou dans le chunk (0 => fin) */
+                    std::size_t mRow = 0;
+                    /** @brief Colonnes des types demandés dans l'archétype courant */
+                    std::array<int, sizeof...(Ts)> mColumns{};
+                    /** @brief L'entité courante */
+                    EntityID mEntityID = NULL_ENTITY;
+                    /** @brief Les composants de l'entité courante */
+                    std::tuple<Ts*...> mCurrent;
+
+                    /**
+                     * @brief Recule jusqu'à la prochaine entité qui possède tous les composants demandés
+                     * 
+                     */
+                    void Seek() {
+                        // Des entités ont pu être supprimées pendant le parcours
+                        if(mRow > mView->mDriver->size()) mRow = mView->mDriver->size();
+
+                        while(mRow > 0) {
+                            mEntityID = (*mView->mDriver)[mRow - 1];
+
+                            // Un seul test de signature suffit à savoir si l'entité possède tous les composants
+                            if(((*mView->mSignatures)[EntityIndex(mEntityID)] & mView->mMask) == mView->mMask) {
+                                mCurrent = { Fetch(std::get<ComponentStorage<StorageType<Ts>>*>(mView->mStorages))... };
+                                return;
+                            }
+                            --mRow;
+                        }
+                    }
+
+                    template<typename S>
+                    auto* Fetch(S* storage) const {
+                        return &storage->GetAt(storage->IndexOf(mEntityID));
+                    }
+
+                    template<std::size_t... I>
+                    void Fetch(const Archetype& archetype, std::index_sequence<I...>) {
+                        mEntityID = archetype.Entities(mChunk)[mRow - 1];
+                        mCurrent = { (static_cast<Ts*>(archetype.Column(mColumns[I], mChunk)) + (mRow - 1))... };
+                    }
+
+                    /**
+                     * @brief Recule jusqu'à la prochaine ligne d'un archétype qui contient tous les types demandés
+                     * 
+                     */
+                    void SeekArchetype() {
+                        const std::vector<Archetype*>& archetypes = *mView->mArchetypes;
+                        if(mArchetype > archetypes.size()) mArchetype = archetypes.size();
+
+                        while(mArchetype > 0) {
+                            const Archetype& archetype = *archetypes[mArchetype - 1];
+
+                            if(archetype.Size() > 0 && (mChunk != NPOS || mView->Matches(archetype, mColumns))) {
+                                // Des entités (et donc des chunks) ont pu être supprimées pendant le parcours
+                                if(mChunk >= archetype.ChunkCount()) {
+                                    mChunk = archetype.ChunkCount() - 1;
+                                    mRow = NPOS;
+                                }
+                                if(mRow > archetype.ChunkSize(mChunk)) mRow = archetype.ChunkSize(mChunk);
+
+                                while(mRow == 0 && mChunk > 0) {
+                                    --mChunk;
+                                    mRow = archetype.ChunkSize(mChunk);
+                                }
+
+                                if(mRow > 0) {
+                                    Fetch(archetype, std::index_sequence_for<Ts...>{});
+                                    return;
+                                }
+                            }
+
+                            --mArchetype;
+                            mChunk = NPOS;
+                            mRow = NPOS;
+                        }
+
+                        mChunk = 0;
+                        mRow = 0;
+                    }
+
+                public:
+                    Iterator(const View* view, bool begin) : mView(view) {
+                        if(!begin) return;
+
+                        if(mView->mArchetypes) {
+                            mArchetype = mView->mArchetypes->size();
+                            mChunk = NPOS;
+                            mRow = NPOS;
+                            SeekArchetype();
+                        } else if(mView->mDriver) {
+                            mRow = mView->mDriver->size();
+                            Seek();
+                        }
+                    }
+
+                    value_type operator*() const {
+                        return value_type(mEntityID, *std::get<Ts*>(mCurrent)...);
+                    }
+
+                    Iterator& operator++() {
+                        --mRow;
+                        if(mView->mArchetypes) SeekArchetype();
+                        else Seek();
+                        return *this;
+                    }
+
+                    bool operator==(const Iterator& other) const {
+                        return mArchetype == other.mArchetype && mChunk == other.mChunk && mRow == other.mRow;
+                    }
+                    bool operator!=(const Iterator& other) const { return !(*this == other); }
+            };
+
+            /**
+             * @brief Construit une vue à partir des stockages concernés
+             * 
+             * Si l'un des stockages n'existe pas, la vue est vide.
+             * 
+             * @param signatures Les signatures des entités du registre
+             * @param mask La signature des types demandés
+             * @param storages
+             */
+            View(const PagedArray<Signature>& signatures, Signature mask, ComponentStorage<StorageType<Ts>>*... storages)
+                : mStorages(storages...), mSignatures(&signatures), mMask(mask) {
+                if(((storages == nullptr) || ...)) return;
+
+                std::size_t smallest = static_cast<std::size_t>(-1);
+                ((storages->Size() < smallest ? (smallest = storages->Size(), mDriver = &storages->GetEntities()) : mDriver), ...);
+            }
+
+            /**
+             * @brief Construit une vue dirigée par une liste d'entités donnée (celle d'un Group, par exemple)
+             * 
+             * Si l'un des stockages n'existe pas, la vue est vide.
+             * 
+             * @param entities Les entités à parcourir, qui doivent rester valides pendant toute la durée de vie de la vue
+             * @param signatures Les signatures des entités du registre
+             * @param mask La signature des types demandés
+             * @param storages
+             */
+            View(const std::vector<EntityID>& entities, const PagedArray<Signature>& signatures, Signature mask, ComponentStorage<StorageType<Ts>>*... storages)
+                : mStorages(storages...), mSignatures(&signatures), mMask(mask) {
+                if(((storages == nullptr) || ...)) return;
+
+                mDriver = &entities;
+            }
+
+            /**
+             * @brief Construit une vue qui parcourt les archétypes donnés
+             * 
+             * Si l'un des types demandés n'est pas compact (Behaviour), la vue parcourt les stockages à la place.
+             * 
+             * @param archetypes Le stockage d'archétypes du registre
+             * @param typeIDs Les identifiants des types demandés
+             * @param signatures Les signatures des entités du registre
+             * @param mask La signature des types demandés
+             * @param storages
+             */
+            View(const ArchetypeStorage& archetypes, std::array<std::size_t, sizeof...(Ts)> typeIDs, const PagedArray<Signature>& signatures, Signature mask, ComponentStorage<StorageType<Ts>>*... storages)
+                : View(signatures, mask, storages...) {
+                if constexpr (AllPacked) {
+                    if(!mDriver) return;
+
+                    mArchetypes = &archetypes.GetArchetypes();
+                    mTypeIDs = typeIDs;
+                }
+            }
+
+            Iterator begin() const { return Iterator(this, true); }
+            Iterator end() const { return Iterator(this, false); }
+
+            /**
+             * @brief Renvoie une borne supérieure du nombre d'entités de la vue
+             * 
+             * @return std::size_t
+             */
+            std::size_t SizeHint() const {
+                if(!mArchetypes) return mDriver ? mDriver->size() : 0;
+
+                std::size_t size = 0;
+                std::array<int, sizeof...(Ts)> columns;
+                for(const Archetype* archetype : *mArchetypes) {
+                    if(Matches(*archetype, columns)) size += archetype->Size();
+                }
+
+                return size;
+            }
+
+            /**
+             * @brief Appelle la fonction donnée pour chaque entité de la vue
+             * 
+             * @tparam Func Signature attendue : void(EntityID, Ts&...)
+             * @param func
+             */
+            template<typename Func>
+            void Each(Func&& func) const {
+                for(auto it = begin(); it != end(); ++it) std::apply(func, *it);
+            }
+    };
+}
@@ -1,29 +1,34 @@
 #include "particlesystem.hpp"
 
-#include "../ecs/entity.hpp"
+#include "../ecs/commandbuffer.hpp"
 #include "../scene/transform.hpp"
 #include "../utils/rng.hpp"
 #include "sprite.hpp"
 
 using namespace Engine::Scene;
 namespace Engine::Graphics {
+    ParticleSystem::ParticleSystem() {
+        Writes<Particle, ParticleEmitter, Transform, Sprite>();
+    }
+
     void ParticleSystem::OnUpdate(float deltaTime) {
-        // Update lifetime and remove dead particles
-        for (auto entityID : GetRegistry().GetEntityIDsWith<Particle, Transform, Sprite>()) {
-            auto& particle = GetRegistry().GetComponent<Particle>(entityID);
-            auto& transform = GetRegistry().GetComponent<Transform>(entityID);
-            auto& sprite = GetRegistry().GetComponent<Sprite>(entityID);
+        // Les créations/destructions de particules sont différées : App les applique en une fois à la fin de l'update
+        ECS::CommandBuffer& commands = GetRegistry().GetCommandBuffer();
+        std::size_t particleCount = GetRegistry().Count<Particle>();
 
+        // Update lifetime and remove dead particles
+        for (auto [entityID, particle, transform, sprite] : GetRegistry().View<Particle, Transform, Sprite>()) {
             if(!(particle.enabled && transform.enabled && sprite.enabled)) continue;
 
             particle.lifetime += deltaTime;
             if (particle.lifetime >= particle.maxLifetime) {
-                GetRegistry().DestroyEntity(entityID);
+                commands.DestroyEntity(entityID);
+                particleCount--;
                 continue;
             }
 
             // Move particle
-            transform.position += glm::vec3(particle.velocity) * deltaTime;
+            transform.Translate(glm::vec3(particle.velocity) * deltaTime);
 
             // Optional: fade opacity, reduce size, etc.
             if(particle.fadeOut) {
@@ -33,10 +38,7 @@ namespace Engine::Graphics {
         }
 
          // Emit particles from emitters
-        for (auto entityID : GetRegistry().GetEntityIDsWith<ParticleEmitter, Transform>()) {
-            auto& emitter = GetRegistry().GetComponent<ParticleEmitter>(entityID);
-            auto& transform = GetRegistry().GetComponent<Transform>(entityID);
-
+        for (auto [entityID, emitter, transform] : GetRegistry().View<ParticleEmitter, const Transform>()) {
             if(!(emitter.enabled && transform.enabled)) continue;
             if (!emitter.active) continue;
 
@@ -47,11 +49,11 @@ namespace Engine::Graphics {
                 emitter.timeSinceLastEmission -= interval;
 
                 // Create new particle
-                if (GetRegistry().GetEntityIDsWith<Particle>().size() < emitter.maxParticles) {
-                    ECS::Entity particle(GetRegistry().CreateEntity(), &GetRegistry());
+                if (particleCount < emitter.maxParticles) {
+                    EntityID particle = commands.CreateEntity();
+                    particleCount++;
 
-                    Transform pTransform = transform; // start at emitter position
-                    particle.AddComponent<Transform>(pTransform);
+                    commands.AddComponent<Transform>(particle, transform); // start at emitter position
 
                     float initialSpeed = emitter.particleMaxInitialSpeed < emitter.particleMinInitialSpeed ? emitter.particleMaxInitialSpeed : 
                         emitter.particleMinInitialSpeed > emitter.particleMaxInitialSpeed ? emitter.particleMinInitialSpeed : 
@@ -77,11 +79,13 @@ namespace Engine::Graphics {
                     p.initialOpacity = initialOpacity;
                     p.fadeOut = emitter.fadeOut;
 
-                    particle.AddComponent<Particle>(p);
-                    auto& sprite = particle.AddComponent<Sprite>();
+                    Sprite sprite;
                     sprite.material = Material(emitter.sourceMaterial);
                     sprite.size = glm::vec3(initialSize);
                     sprite.material.color.a = p.initialOpacity;
+
+                    commands.AddComponent<Particle>(particle, p);
+                    commands.AddComponent<Sprite>(particle, sprite);
                 }
             }
         }
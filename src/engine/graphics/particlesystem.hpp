@@ -80,6 +80,12 @@ namespace Engine::Graphics {
      */
     class ParticleSystem : public ECS::System {
         public:
+            /**
+             * @brief Déclare les composants utilisés par le système (les particules sont créées et détruites via le tampon de commandes)
+             * 
+             */
+            ParticleSystem();
+
             /**
              * @brief Callback d'upadte du système de particules
              * 
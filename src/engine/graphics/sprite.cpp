@@ -71,17 +71,13 @@ namespace Engine::Graphics {
     }
 
     void SpriteAnimationSystem::OnUpdate(float deltaTime) {
-        for (auto entityID : GetRegistry().GetEntityIDsWith<SpriteAnimator, Sprite>()) {
-            auto& animator = GetRegistry().GetComponent<SpriteAnimator>(entityID);
+        for (auto [entityID, animator, sprite] : GetRegistry().View<SpriteAnimator, Sprite>()) {
             if(!animator.enabled) continue;
 
             animator.Update(deltaTime);
 
             Graphics::Texture* frame = animator.GetCurrentFrame();
-            if(frame) {
-                auto& sprite = GetRegistry().GetComponent<Sprite>(entityID);
-                sprite.material.texture = frame;
-            }
+            if(frame) sprite.material.texture = frame;
         }
     }
 }
\ No newline at end of file
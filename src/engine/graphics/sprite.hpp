@@ -103,6 +103,12 @@ namespace Engine::Graphics {
 
     class SpriteAnimationSystem : public ECS::System {
         public:
+            /**
+             * @brief Déclare les composants utilisés par le système
+             * 
+             */
+            SpriteAnimationSystem() { Writes<SpriteAnimator, Sprite>(); }
+
             /**
              * @brief Callback d'upadte du système d'animation de sprite
              * 
@@ -0,0 +1,266 @@
+#include "aabbtree.hpp"
+
+#include <algorithm>
+
+namespace Engine::Physics {
+    namespace {
+        /** @brief Périmètre de la boîte [min, max] : le coût d'un noeud pour l'heuristique d'insertion */
+        inline float Perimeter(const glm::vec2& min, const glm::vec2& max) {
+            return 2.0f * ((max.x - min.x) + (max.y - min.y));
+        }
+    }
+
+    AABBTree::AABBTree(float margin) : mMargin(margin) {}
+
+    int32_t AABBTree::AllocateNode() {
+        if(mFreeList == NULL_NODE) {
+            mNodes.emplace_back();
+            return static_cast<int32_t>(mNodes.size() - 1);
+        }
+
+        int32_t node = mFreeList;
+        mFreeList = mNodes[node].parent;
+        mNodes[node] = Node{};
+        return node;
+    }
+
+    void AABBTree::FreeNode(int32_t node) {
+        mNodes[node].parent = mFreeList;
+        mNodes[node].height = -1;
+        mNodes[node].entity = NULL_ENTITY;
+        mFreeList = node;
+    }
+
+    void AABBTree::InsertLeaf(int32_t leaf) {
+        if(mRoot == NULL_NODE) {
+            mRoot = leaf;
+            mNodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // Descente vers le frère le moins coûteux : le coût d'une branche est l'augmentation du périmètre de ses boîtes
+        glm::vec2 leafMin = mNodes[leaf].min;
+        glm::vec2 leafMax = mNodes[leaf].max;
+        int32_t index = mRoot;
+        while(!mNodes[index].IsLeaf()) {
+            const Node& node = mNodes[index];
+            float area = Perimeter(node.min, node.max);
+            float combinedArea = Perimeter(glm::min(node.min, leafMin), glm::max(node.max, leafMax));
+
+            // Coût d'un nouveau parent pour ce noeud et la feuille, et coût minimal transmis aux enfants si on descend
+            float cost = 2.0f * combinedArea;
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto childCost = [&](int32_t child) {
+                const Node& c = mNodes[child];
+                float enlarged = Perimeter(glm::min(c.min, leafMin), glm::max(c.max, leafMax));
+                return (c.IsLeaf() ? enlarged : enlarged - Perimeter(c.min, c.max)) + inheritanceCost;
+            };
+            float cost1 = childCost(node.child1);
+            float cost2 = childCost(node.child2);
+
+            if(cost < cost1 && cost < cost2) break;
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        // Un nouveau parent remplace le frère, et prend le frère et la feuille comme enfants
+        int32_t sibling = index;
+        int32_t oldParent = mNodes[sibling].parent;
+        int32_t newParent = AllocateNode();
+        Node& parent = mNodes[newParent];
+        parent.parent = oldParent;
+        parent.min = glm::min(mNodes[sibling].min, leafMin);
+        parent.max = glm::max(mNodes[sibling].max, leafMax);
+        parent.height = mNodes[sibling].height + 1;
+        parent.child1 = sibling;
+        parent.child2 = leaf;
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+
+        if(oldParent == NULL_NODE) {
+            mRoot = newParent;
+        } else if(mNodes[oldParent].child1 == sibling) {
+            mNodes[oldParent].child1 = newParent;
+        } else {
+            mNodes[oldParent].child2 = newParent;
+        }
+
+        Refit(oldParent);
+    }
+
+    void AABBTree::RemoveLeaf(int32_t leaf) {
+        if(leaf == mRoot) {
+            mRoot = NULL_NODE;
+            return;
+        }
+
+        int32_t parent = mNodes[leaf].parent;
+        int32_t grandParent = mNodes[parent].parent;
+        int32_t sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+        // Le frère prend la place du parent, qui disparaît
+        mNodes[sibling].parent = grandParent;
+        FreeNode(parent);
+        if(grandParent == NULL_NODE) {
+            mRoot = sibling;
+            return;
+        }
+
+        if(mNodes[grandParent].child1 == parent) {
+            mNodes[grandParent].child1 = sibling;
+        } else {
+            mNodes[grandParent].child2 = sibling;
+        }
+        Refit(grandParent);
+    }
+
+    void AABBTree::Refit(int32_t node) {
+        while(node != NULL_NODE) {
+            node = Balance(node);
+
+            Node& n = mNodes[node];
+            const Node& c1 = mNodes[n.child1];
+            const Node& c2 = mNodes[n.child2];
+            n.height = 1 + std::max(c1.height, c2.height);
+            n.min = glm::min(c1.min, c2.min);
+            n.max = glm::max(c1.max, c2.max);
+
+            node = n.parent;
+        }
+    }
+
+    int32_t AABBTree::Balance(int32_t iA) {
+        Node& a = mNodes[iA];
+        if(a.IsLeaf() || a.height < 2) return iA;
+
+        int32_t iB = a.child1;
+        int32_t iC = a.child2;
+        int32_t balance = mNodes[iC].height - mNodes[iB].height;
+        if(balance >= -1 && balance <= 1) return iA;
+
+        // Le sous-arbre le plus haut (iUp) prend la place de A. A devient son enfant, et récupère le plus petit de ses deux enfants.
+        bool rotateC = balance > 1;
+        int32_t iUp = rotateC ? iC : iB;
+        int32_t iOther = rotateC ? iB : iC;
+        Node& up = mNodes[iUp];
+        int32_t iF = up.child1;
+        int32_t iG = up.child2;
+
+        up.child1 = iA;
+        up.parent = a.parent;
+        a.parent = iUp;
+
+        if(up.parent == NULL_NODE) {
+            mRoot = iUp;
+        } else if(mNodes[up.parent].child1 == iA) {
+            mNodes[up.parent].child1 = iUp;
+        } else {
+            mNodes[up.parent].child2 = iUp;
+        }
+
+        // Le petit-enfant le plus haut reste sous iUp, l'autre passe sous A à la place de iUp
+        int32_t iKeep = mNodes[iF].height > mNodes[iG].height ? iF : iG;
+        int32_t iMove = iKeep == iF ? iG : iF;
+        up.child2 = iKeep;
+        if(rotateC) a.child2 = iMove;
+        else a.child1 = iMove;
+        mNodes[iMove].parent = iA;
+
+        const Node& other = mNodes[iOther];
+        const Node& moved = mNodes[iMove];
+        a.min = glm::min(other.min, moved.min);
+        a.max = glm::max(other.max, moved.max);
+        a.height = 1 + std::max(other.height, moved.height);
+
+        const Node& kept = mNodes[iKeep];
+        up.min = glm::min(a.min, kept.min);
+        up.max = glm::max(a.max, kept.max);
+        up.height = 1 + std::max(a.height, kept.height);
+
+        return iUp;
+    }
+
+    void AABBTree::Update(EntityID entityID, const AABB& aabb) {
+        glm::vec2 min = aabb.Min();
+        glm::vec2 max = aabb.Max();
+
+        uint32_t entityIndex = EntityIndex(entityID);
+        if(entityIndex >= mProxyIndex.size()) mProxyIndex.resize(entityIndex + 1, EMPTY_PROXY);
+
+        uint32_t leaf = mProxyIndex[entityIndex];
+        if(leaf != EMPTY_PROXY && mNodes[leaf].entity != entityID) {
+            // L'index a été recyclé par une nouvelle entité : l'ancienne quitte l'arbre
+            Remove(mNodes[leaf].entity);
+            leaf = EMPTY_PROXY;
+        }
+
+        if(leaf != EMPTY_PROXY) {
+            Node& node = mNodes[leaf];
+            node.stamp = mStamp;
+            // L'AABB est encore dans la boîte élargie : l'arbre ne bouge pas
+            if(node.min.x <= min.x && node.min.y <= min.y && max.x <= node.max.x && max.y <= node.max.y) return;
+
+            RemoveLeaf(static_cast<int32_t>(leaf));
+        } else {
+            leaf = static_cast<uint32_t>(AllocateNode());
+            mProxyIndex[entityIndex] = leaf;
+            ++mLeafCount;
+        }
+
+        Node& node = mNodes[leaf];
+        node.min = min - glm::vec2(mMargin);
+        node.max = max + glm::vec2(mMargin);
+        node.height = 0;
+        node.child1 = node.child2 = NULL_NODE;
+        node.entity = entityID;
+        node.stamp = mStamp;
+        InsertLeaf(static_cast<int32_t>(leaf));
+    }
+
+    void AABBTree::Remove(EntityID entityID) {
+        uint32_t entityIndex = EntityIndex(entityID);
+        if(entityIndex >= mProxyIndex.size()) return;
+
+        uint32_t leaf = mProxyIndex[entityIndex];
+        if(leaf == EMPTY_PROXY || mNodes[leaf].entity != entityID) return;
+
+        RemoveLeaf(static_cast<int32_t>(leaf));
+        FreeNode(static_cast<int32_t>(leaf));
+        mProxyIndex[entityIndex] = EMPTY_PROXY;
+        --mLeafCount;
+    }
+
+    void AABBTree::RemoveStale() {
+        for(const Node& node : mNodes) {
+            if(node.height == 0 && node.stamp != mStamp) Remove(node.entity);
+        }
+        ++mStamp;
+    }
+
+    void AABBTree::Clear() {
+        mNodes.clear();
+        mProxyIndex.clear();
+        mRoot = NULL_NODE;
+        mFreeList = NULL_NODE;
+        mLeafCount = 0;
+        mStamp = 0;
+    }
+
+    void AABBTree::CollectPairs(std::vector<std::pair<EntityID, EntityID>>& out) {
+        // Chaque feuille cherche les feuilles qui la touchent : la paire n'est gardée que depuis la feuille d'index le plus faible
+        for(int32_t leaf = 0; leaf < static_cast<int32_t>(mNodes.size()); ++leaf) {
+            const Node& node = mNodes[leaf];
+            if(node.height != 0) continue;
+
+            ForEachOverlap(node.min, node.max, [&](const Node& other) {
+                if(&other > &node) out.emplace_back(node.entity, other.entity);
+            });
+        }
+    }
+
+    void AABBTree::Query(const AABB& aabb, std::vector<EntityID>& out) {
+        ForEachOverlap(aabb.Min(), aabb.Max(), [&](const Node& node) {
+            out.push_back(node.entity);
+        });
+    }
+}
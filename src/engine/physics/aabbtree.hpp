@@ -0,0 +1,199 @@
+/**
+ * @file aabbtree.hpp
+ * @brief Définit un arbre d'AABB dynamique, utilisable comme broadphase par le système physique
+ * 
+ * Chaque feuille de l'arbre contient une entité et une AABB élargie (la boîte "fat") qui l'englobe.
+ * Chaque noeud interne englobe ses deux enfants : une requête ne descend que dans les branches qui touchent la zone cherchée.
+ * 
+ * L'arbre est persistant : une entité qui reste dans sa boîte élargie ne le modifie pas. Sinon, sa feuille est retirée
+ * puis réinsérée, et seuls les ancêtres concernés sont recalculés (et rééquilibrés par rotations).
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../defs.hpp"
+#include "../constants.hpp"
+#include "aabb.hpp"
+#include "broadphase.hpp"
+
+namespace Engine::Physics {
+    /**
+     * @brief Arbre binaire d'AABB dynamique (Bounding Volume Hierarchy)
+     * 
+     * Les noeuds sont rangés dans un tableau et recyclés par une liste de noeuds libres : l'arbre n'alloue rien une fois rempli.
+     */
+    class AABBTree : public IBroadPhase {
+        private:
+            /** @brief Index d'un noeud inexistant */
+            static constexpr int32_t NULL_NODE = -1;
+            /** @brief Valeur de mProxyIndex pour une entité absente de l'arbre */
+            static constexpr uint32_t EMPTY_PROXY = UINT32_MAX;
+
+            /** @brief Un noeud de l'arbre : une feuille (une entité) ou un noeud interne (deux enfants) */
+            struct Node {
+                /** @brief Boîte englobante du noeud (élargie pour une feuille) */
+                glm::vec2 min, max;
+                /** @brief Parent du noeud, ou noeud libre suivant si le noeud n'est pas utilisé */
+                int32_t parent = NULL_NODE;
+                int32_t child1 = NULL_NODE;
+                int32_t child2 = NULL_NODE;
+                /** @brief Hauteur du sous-arbre : 0 pour une feuille, -1 pour un noeud libre */
+                int32_t height = -1;
+                EntityID entity = NULL_ENTITY;
+                /** @brief Valeur de mStamp lors du dernier Update de l'entité (feuilles seulement) */
+                uint32_t stamp = 0;
+
+                bool IsLeaf() const { return child1 == NULL_NODE; }
+            };
+
+            float mMargin;
+
+            std::vector<Node> mNodes;
+            int32_t mRoot = NULL_NODE;
+            /** @brief Premier noeud libre (chaîné par Node::parent) */
+            int32_t mFreeList = NULL_NODE;
+            /** @brief Index d'entité => feuille de l'entité (EMPTY_PROXY si l'entité n'est pas dans l'arbre) */
+            std::vector<uint32_t> mProxyIndex;
+            size_t mLeafCount = 0;
+            uint32_t mStamp = 0;
+
+            /** @brief Pile de parcours réutilisée par les requêtes */
+            std::vector<int32_t> mStack;
+
+            /**
+             * @brief Renvoie un noeud libre (le tableau grandit si besoin)
+             * 
+             * @return int32_t
+             */
+            int32_t AllocateNode();
+            /**
+             * @brief Rend un noeud à la liste des noeuds libres
+             * 
+             * @param node
+             */
+            void FreeNode(int32_t node);
+
+            /**
+             * @brief Range une feuille dans l'arbre, à côté du noeud qui grossit le moins en l'accueillant
+             * 
+             * @param leaf
+             */
+            void InsertLeaf(int32_t leaf);
+            /**
+             * @brief Détache une feuille de l'arbre (son parent disparaît, son frère prend sa place)
+             * 
+             * @param leaf
+             */
+            void RemoveLeaf(int32_t leaf);
+            /**
+             * @brief Remonte de node jusqu'à la racine en rééquilibrant et en recalculant les boîtes des ancêtres
+             * 
+             * @param node
+             */
+            void Refit(int32_t node);
+            /**
+             * @brief Fait remonter l'enfant le plus haut si les deux sous-arbres du noeud sont déséquilibrés (rotation)
+             * 
+             * @param node
+             * @return int32_t Le noeud qui a pris la place de node
+             */
+            int32_t Balance(int32_t node);
+
+            /**
+             * @brief Appelle func(leaf) pour chaque feuille dont la boîte touche [min, max]
+             * 
+             * @tparam Func
+             * @param min
+             * @param max
+             * @param func func(const Node&)
+             */
+            template<typename Func>
+            void ForEachOverlap(const glm::vec2& min, const glm::vec2& max, Func&& func) {
+                if(mRoot == NULL_NODE) return;
+
+                mStack.clear();
+                mStack.push_back(mRoot);
+                while(!mStack.empty()) {
+                    const Node& node = mNodes[mStack.back()];
+                    mStack.pop_back();
+
+                    if(node.max.x < min.x || node.min.x > max.x || node.max.y < min.y || node.min.y > max.y) continue;
+
+                    if(node.IsLeaf()) {
+                        func(node);
+                    } else {
+                        mStack.push_back(node.child1);
+                        mStack.push_back(node.child2);
+                    }
+                }
+            }
+
+        public:
+            /**
+             * @brief Construit un arbre vide
+             * 
+             * @param margin Marge ajoutée autour des AABB des entités (en unités du monde)
+             */
+            explicit AABBTree(float margin = AABB_TREE_FAT_MARGIN);
+
+            /**
+             * @brief Ajoute l'entité à l'arbre, ou met à jour sa feuille
+             * 
+             * Si l'AABB reste dans la boîte élargie de la feuille, rien n'est déplacé.
+             * 
+             * @param entityID
+             * @param aabb
+             */
+            void Update(EntityID entityID, const AABB& aabb) override;
+
+            /**
+             * @brief Retire l'entité de l'arbre (sans effet si elle n'y est pas)
+             * 
+             * @param entityID
+             */
+            void Remove(EntityID entityID) override;
+
+            /**
+             * @brief Retire les entités qui n'ont pas été mises à jour depuis le dernier appel à RemoveStale
+             * 
+             */
+            void RemoveStale() override;
+
+            /**
+             * @brief Vide l'arbre (les noeuds sont libérés)
+             * 
+             */
+            void Clear() override;
+
+            /**
+             * @brief Renvoie le nombre d'entités de l'arbre
+             * 
+             * @return size_t
+             */
+            size_t Size() const override { return mLeafCount; }
+
+            /**
+             * @brief Ajoute à out les paires d'entités dont les boîtes élargies se touchent (chaque paire une seule fois)
+             * 
+             * @param out
+             */
+            void CollectPairs(std::vector<std::pair<EntityID, EntityID>>& out) override;
+
+            /**
+             * @brief Ajoute à out les entités dont la boîte élargie touche l'AABB
+             * 
+             * @param aabb
+             * @param out
+             */
+            void Query(const AABB& aabb, std::vector<EntityID>& out) override;
+
+            /**
+             * @brief Renvoie la hauteur de l'arbre (0 s'il est vide ou ne contient qu'une feuille)
+             * 
+             * @return int32_t
+             */
+            int32_t GetHeight() const { return mRoot == NULL_NODE ? 0 : mNodes[mRoot].height; }
+    };
+}
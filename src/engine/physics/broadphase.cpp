@@ -0,0 +1,15 @@
+#include "broadphase.hpp"
+#include "spatialhash.hpp"
+#include "aabbtree.hpp"
+#include "sweepandprune.hpp"
+
+namespace Engine::Physics {
+    std::unique_ptr<IBroadPhase> CreateBroadPhase(BroadPhaseType type) {
+        switch(type) {
+            case BroadPhaseType::AABBTree: return std::make_unique<AABBTree>();
+            case BroadPhaseType::SweepAndPrune: return std::make_unique<SweepAndPrune>();
+            case BroadPhaseType::SpatialHash:
+            default: return std::make_unique<SpatialHash>();
+        }
+    }
+}
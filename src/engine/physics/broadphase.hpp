@@ -0,0 +1,126 @@
+/**
+ * @file broadphase.hpp
+ * @brief Définit l'interface commune aux structures de broadphase du système physique
+ * 
+ * La broadphase est le premier "jet" de la détection de collisions : elle range les colliders par leurs AABB
+ * et renvoie les paires qui pourraient être en contact. Les tests précis (OBB) ne sont faits que sur ces paires.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../defs.hpp"
+#include "aabb.hpp"
+
+namespace Engine::Physics {
+    /**
+     * @brief Les différentes broadphases disponibles, à choisir par scène (voir Scene::SetBroadPhase)
+     * 
+     */
+    enum class BroadPhaseType {
+        /** @brief Grille de cellules de taille fixe : efficace quand les colliders ont des tailles proches */
+        SpatialHash,
+        /** @brief Arbre d'AABB dynamique : s'adapte aux colliders de tailles très différentes et aux scènes clairsemées */
+        AABBTree,
+        /** @brief Tri des AABB sur X (sweep and prune) : adapté aux niveaux horizontaux, où peu de colliders se chevauchent sur X */
+        SweepAndPrune
+    };
+
+    /**
+     * @brief Renvoie la clé d'une paire d'entités : le plus petit ID dans les 32 bits de poids fort, le plus grand derrière
+     * 
+     * La clé ne dépend pas de l'ordre de a et b, et trier des clés revient à trier les paires.
+     * 
+     * @param a 
+     * @param b 
+     * @return uint64_t 
+     */
+    inline uint64_t PackPair(EntityID a, EntityID b) {
+        return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+    }
+
+    /**
+     * @brief Renvoie la paire d'entités d'une clé construite par PackPair
+     * 
+     * @param key 
+     * @return std::pair<EntityID, EntityID> 
+     */
+    inline std::pair<EntityID, EntityID> UnpackPair(uint64_t key) {
+        return {static_cast<EntityID>(key >> 32), static_cast<EntityID>(key)};
+    }
+
+    /**
+     * @brief Interface d'une broadphase persistante
+     * 
+     * Les entités y sont ajoutées et déplacées par Update, et gardées d'un pas physique à l'autre.
+     * CollectPairs et Query ne sont pas const : une broadphase peut finir de ranger ses entités avant de répondre.
+     */
+    class IBroadPhase {
+        public:
+            virtual ~IBroadPhase() = default;
+
+            /**
+             * @brief Ajoute l'entité à la broadphase, ou met à jour sa place
+             * 
+             * @param entityID
+             * @param aabb
+             */
+            virtual void Update(EntityID entityID, const AABB& aabb) = 0;
+
+            /**
+             * @brief Retire l'entité de la broadphase (sans effet si elle n'y est pas)
+             * 
+             * @param entityID
+             */
+            virtual void Remove(EntityID entityID) = 0;
+
+            /**
+             * @brief Retire les entités qui n'ont pas été mises à jour depuis le dernier appel à RemoveStale
+             * 
+             */
+            virtual void RemoveStale() = 0;
+
+            /**
+             * @brief Vide la broadphase
+             * 
+             */
+            virtual void Clear() = 0;
+
+            /**
+             * @brief Renvoie le nombre d'entités de la broadphase
+             * 
+             * @return size_t
+             */
+            virtual size_t Size() const = 0;
+
+            /**
+             * @brief Ajoute à out les paires d'entités de la broadphase qui sont peut-être en contact
+             * 
+             * Une même paire peut apparaître plusieurs fois, dans un ordre quelconque.
+             * 
+             * @param out
+             */
+            virtual void CollectPairs(std::vector<std::pair<EntityID, EntityID>>& out) = 0;
+
+            /**
+             * @brief Ajoute à out les entités qui sont peut-être en contact avec l'AABB
+             * 
+             * Une même entité peut apparaître plusieurs fois.
+             * 
+             * @param aabb
+             * @param out
+             */
+            virtual void Query(const AABB& aabb, std::vector<EntityID>& out) = 0;
+    };
+
+    /**
+     * @brief Construit une broadphase vide du type demandé
+     * 
+     * @param type
+     * @return std::unique_ptr<IBroadPhase>
+     */
+    std::unique_ptr<IBroadPhase> CreateBroadPhase(BroadPhaseType type);
+}
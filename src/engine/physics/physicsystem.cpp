@@ -5,13 +5,194 @@ using namespace Engine::Scene;
 #include <iostream>
 #include <random>
 #include <chrono>
-#include <iostream>
+#include <cmath>
+#include <algorithm>
 using namespace std::chrono;
 
 namespace Engine::Physics {
+    namespace {
+        /** @brief En dessous de ce nombre de clés, std::sort est plus rapide que le tri par base */
+        constexpr size_t RADIX_SORT_THRESHOLD = 256;
+
+        /**
+         * @brief Trie des clés 64 bits par base (LSD, chiffres de 8 bits)
+         * 
+         * Les 8 histogrammes sont calculés en une seule passe, et les chiffres identiques pour toutes les clés sont sautés :
+         * avec de petits EntityID, seuls quelques octets de chaque moitié de la clé sont réellement triés.
+         * 
+         * @param keys Les clés à trier
+         * @param scratch Tableau de travail, redimensionné si besoin
+         */
+        void RadixSortKeys(std::vector<uint64_t>& keys, std::vector<uint64_t>& scratch) {
+            if(keys.size() < RADIX_SORT_THRESHOLD) {
+                std::sort(keys.begin(), keys.end());
+                return;
+            }
+
+            uint32_t counts[8][256] = {};
+            for(uint64_t key : keys) {
+                for(int digit = 0; digit < 8; ++digit) ++counts[digit][(key >> (digit * 8)) & 0xFF];
+            }
+
+            scratch.resize(keys.size());
+            for(int digit = 0; digit < 8; ++digit) {
+                uint32_t* count = counts[digit];
+                // Toutes les clés ont le même chiffre : la passe ne changerait rien
+                if(count[(keys[0] >> (digit * 8)) & 0xFF] == keys.size()) continue;
+
+                uint32_t offset = 0;
+                for(int value = 0; value < 256; ++value) {
+                    uint32_t c = count[value];
+                    count[value] = offset;
+                    offset += c;
+                }
+                for(uint64_t key : keys) scratch[count[(key >> (digit * 8)) & 0xFF]++] = key;
+                keys.swap(scratch);
+            }
+        }
+    }
+
+    void PhysicSystem::OnInit() {
+        mAABBTick = 0;
+        BroadPhaseType broadPhase = GetRegistry().GetScene().GetBroadPhase();
+        mDynamicBroadPhase = CreateBroadPhase(broadPhase);
+        mStaticBroadPhase = CreateBroadPhase(broadPhase);
+
+        mDynamicIDs.clear();
+        mBodies.clear();
+        mContactStatics.clear();
+        mSyncTick = 0;
+        mNeedsFullSync = true;
+    }
+
+    void PhysicSystem::RefreshAABB(Transform& transform, BoxCollider& collider) {
+        collider.aabb = AABB(glm::vec2(transform.GetWorldPosition()), glm::vec2(collider.size * transform.GetWorldScale()), collider.enableRotation ? transform.GetWorldRotation() : glm::quat());
+    }
+
+    void PhysicSystem::SyncBodies() {
+        ECS::Registry& registry = GetRegistry();
+        ChangeTick since = mSyncTick;
+        mSyncTick = registry.AdvanceChangeTick();
+
+        std::vector<EntityID>& ids = mSyncIDs;
+        ids.clear();
+        auto collect = [&ids](EntityID entityID) { ids.push_back(entityID); };
+
+        if(mNeedsFullSync || registry.GetHierarchyVersion() != mHierarchyVersion) {
+            // Chargement de scène ou changement de hiérarchie : tous les colliders sont reclassés (et les statiques recalculés)
+            mNeedsFullSync = false;
+            mHierarchyVersion = registry.GetHierarchyVersion();
+
+            for(auto [entityID, transform, rb, collider] : registry.Group<Transform, Rigidbody, BoxCollider>()) ids.push_back(entityID);
+            for(const BodyEntry& entry : mBodies) {
+                if(entry.type != BodyType::None) ids.push_back(entry.id);
+            }
+        } else {
+            registry.ForEachChanged<Transform>(since, collect);
+            registry.ForEachChanged<Rigidbody>(since, collect);
+            registry.ForEachChanged<BoxCollider>(since, collect);
+            registry.ForEachRemoved<Transform>(since, collect);
+            registry.ForEachRemoved<Rigidbody>(since, collect);
+            registry.ForEachRemoved<BoxCollider>(since, collect);
+
+            // Un enfant suit son parent : les descendants d'un transform modifié sont recalculés aussi
+            size_t changedCount = ids.size();
+            for(size_t i = 0; i < changedCount; ++i) {
+                if(registry.IsValidEntity(ids[i]) && registry.HasComponent<ECS::Children>(ids[i])) registry.ForEachDescendant(ids[i], collect);
+            }
+        }
+
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        for(EntityID entityID : ids) SyncBody(entityID);
+    }
+
+    void PhysicSystem::SyncBody(EntityID entityID) {
+        ECS::Registry& registry = GetRegistry();
+
+        BodyType type = BodyType::None;
+        if(IsCollider(entityID)) type = registry.GetComponent<Rigidbody>(entityID).isKinematic ? BodyType::Static : BodyType::Dynamic;
+
+        uint32_t entityIndex = EntityIndex(entityID);
+        if(entityIndex >= mBodies.size()) mBodies.resize(entityIndex + 1);
+        BodyEntry& entry = mBodies[entityIndex];
+
+        if(entry.id != entityID) {
+            // Évènement d'un ancien occupant de l'index : l'entité actuelle n'est pas concernée
+            if(type == BodyType::None) return;
+            RemoveBody(entry);
+            entry.id = entityID;
+        }
+
+        if(entry.type != type) {
+            RemoveBody(entry);
+            entry.type = type;
+            if(type == BodyType::Dynamic) {
+                entry.dynamicIndex = static_cast<uint32_t>(mDynamicIDs.size());
+                mDynamicIDs.push_back(entityID);
+            }
+        }
+
+        if(type == BodyType::Static) {
+            BoxCollider& collider = registry.GetComponent<BoxCollider>(entityID);
+            RefreshAABB(registry.GetComponent<Transform>(entityID), collider);
+            mStaticBroadPhase->Update(entityID, collider.aabb);
+        }
+    }
+
+    bool PhysicSystem::IsCollider(EntityID entityID) {
+        ECS::Registry& registry = GetRegistry();
+        return registry.IsValidEntity(entityID) && registry.HasComponent<Transform>(entityID) && registry.HasComponent<Rigidbody>(entityID) && registry.HasComponent<BoxCollider>(entityID);
+    }
+
+    void PhysicSystem::DropInvalidBodies() {
+        std::vector<EntityID>& ids = mSyncIDs;
+        ids.clear();
+        for(EntityID entityID : mDynamicIDs) {
+            if(!IsCollider(entityID)) ids.push_back(entityID);
+        }
+        for(EntityID entityID : mContactStatics) {
+            if(!IsCollider(entityID)) ids.push_back(entityID);
+        }
+
+        // SyncBody retire le corps de sa catégorie (et de mDynamicIDs) : on ne le fait pas pendant le parcours
+        for(EntityID entityID : ids) SyncBody(entityID);
+    }
+
+    void PhysicSystem::RemoveBody(BodyEntry& entry) {
+        switch(entry.type) {
+            case BodyType::Dynamic: {
+                // Swap and pop dans la liste des corps dynamiques
+                EntityID moved = mDynamicIDs.back();
+                mDynamicIDs[entry.dynamicIndex] = moved;
+                mBodies[EntityIndex(moved)].dynamicIndex = entry.dynamicIndex;
+                mDynamicIDs.pop_back();
+                mDynamicBroadPhase->Remove(entry.id);
+                break;
+            }
+            case BodyType::Static:
+                mStaticBroadPhase->Remove(entry.id);
+                break;
+            case BodyType::None:
+                break;
+        }
+
+        entry.type = BodyType::None;
+        entry.inContact = false;
+    }
+
+    void PhysicSystem::TrackStaticContact(EntityID entityID) {
+        BodyEntry& entry = mBodies[EntityIndex(entityID)];
+        if(entry.id != entityID || entry.type != BodyType::Static || entry.inContact) return;
+
+        entry.inContact = true;
+        mContactStatics.push_back(entityID);
+    }
+
     void PhysicSystem::OnFixedUpdate(float dt) {
         auto start = high_resolution_clock::now();
 
+        StorePreviousStates();
         ApplyMotion(dt);
         ResolveCollisions(dt);
 
@@ -20,11 +201,18 @@ namespace Engine::Physics {
         physicsTime = elapsed.count() ;
     }
 
+    void PhysicSystem::StorePreviousStates() {
+        for(auto [entityID, transform, rigidbody] : GetRegistry().Group<Transform, Rigidbody>()) {
+            if(!rigidbody.interpolate) continue;
+
+            rigidbody.previousPosition = transform.GetWorldPosition();
+            rigidbody.previousRotation = transform.GetWorldRotation();
+            rigidbody.hasPreviousState = true;
+        }
+    }
+
     void PhysicSystem::ApplyMotion(float dt) {
-        for(auto entityID : GetRegistry().GetEntityIDsWith<Transform, Rigidbody>()) {
-            auto& transform = GetRegistry().GetComponent<Transform>(entityID);
-            auto& rigidbody = GetRegistry().GetComponent<Rigidbody>(entityID);
-            
+        for(auto [entityID, transform, rigidbody] : GetRegistry().Group<Transform, Rigidbody>()) {
             if(!(transform.enabled && rigidbody.enabled)) continue;
 
             if(rigidbody.isKinematic || rigidbody.isSleeping) continue;
@@ -35,7 +223,8 @@ namespace Engine::Physics {
             transform.Translate(rigidbody.velocity * PHYSICS_UNITS_PER_METER * dt);
 
             rigidbody.acceleration = glm::vec3(0.0f);
-            rigidbody.velocity *= PHYSICS_DAMPING_FACTOR;
+            // Le ralentissement est défini par pas de 1 / FIXED_STEP_FRAMERATE : on le ramène à dt pour ne pas dépendre de la fréquence physique
+            rigidbody.velocity *= std::pow(PHYSICS_DAMPING_FACTOR, dt * FIXED_STEP_FRAMERATE);
 
             // Gestion du sleep
             float velocitySquared = glm::length(rigidbody.velocity);
@@ -53,20 +242,31 @@ namespace Engine::Physics {
     }
 
     void PhysicSystem::ResolveCollisions(float dt) {
-        auto collidableIDs = GetRegistry().GetEntityIDsWith<Transform, Rigidbody, BoxCollider>();
-
-        // Randomise l'ordre des entités pour créer un système moins biaisé
-        std::shuffle(
-            collidableIDs.begin(), 
-            collidableIDs.end(), 
-            std::mt19937{std::random_device{}()}
-        );
-
-        // Reset les flags
-        for(auto entityID : collidableIDs) {
-            auto& transform = GetRegistry().GetComponent<Transform>(entityID);
-            auto& rb = GetRegistry().GetComponent<Rigidbody>(entityID);
-            auto& collider = GetRegistry().GetComponent<BoxCollider>(entityID);
+        ECS::Registry& registry = GetRegistry();
+        std::vector<EntityID>& collidableIDs = mCollidableIDs;
+        collidableIDs.clear();
+
+        // Colliders ajoutés, retirés, devenus statiques ou dynamiques, colliders statiques déplacés
+        SyncBodies();
+        DropInvalidBodies();
+
+        // Les corrections de position faites plus bas sont postérieures à ce tick : elles seront vues au prochain pas
+        ChangeTick since = mAABBTick;
+        mAABBTick = registry.AdvanceChangeTick();
+
+        // Reset les flags (seuls les colliders dynamiques sont parcourus)
+        for(EntityID entityID : mDynamicIDs) {
+            auto& transform = registry.GetComponent<Transform>(entityID);
+            auto& rb = registry.GetComponent<Rigidbody>(entityID);
+            auto& collider = registry.GetComponent<BoxCollider>(entityID);
+            collidableIDs.push_back(entityID);
+
+            // Mise à jour du collider, seulement s'il a bougé (un enfant suit son parent : toujours recalculé)
+            if(registry.IsChanged<Transform>(entityID, since) || registry.IsChanged<BoxCollider>(entityID, since) || registry.HasComponent<ECS::Parent>(entityID)) {
+                RefreshAABB(transform, collider);
+            }
+            // La broadphase ne déplace l'entité que si sa nouvelle AABB l'exige
+            mDynamicBroadPhase->Update(entityID, collider.aabb);
 
             if(!(transform.enabled && rb.enabled && collider.enabled)) continue;
     
@@ -79,12 +279,32 @@ namespace Engine::Physics {
 
             rb.onGround = false;
             rb.onWall = false;
-            // Mise à jour du collider
-            collider.aabb = AABB(glm::vec2(transform.GetWorldPosition()), glm::vec2(collider.size * transform.GetWorldScale()), collider.enableRotation ? transform.GetWorldRotation() : glm::quat());
         }
 
-        SpatialHash hash = BuildSpatialHash(collidableIDs);
-        std::vector<std::pair<EntityID, EntityID>> candidates = GenerateBroadPhasePairs(hash);
+        // Colliders statiques en contact : leurs records vieillissent comme ceux des colliders dynamiques
+        std::sort(mContactStatics.begin(), mContactStatics.end());
+        mContactStatics.erase(std::unique(mContactStatics.begin(), mContactStatics.end()), mContactStatics.end());
+        std::erase_if(mContactStatics, [this](EntityID entityID) {
+            const BodyEntry& entry = mBodies[EntityIndex(entityID)];
+            return entry.id != entityID || entry.type != BodyType::Static || !entry.inContact;
+        });
+        for(EntityID entityID : mContactStatics) {
+            auto& collider = registry.GetComponent<BoxCollider>(entityID);
+            for (auto& [id, record] : collider.collisionsList) record.updatedThisFrame = false;
+            for (auto& [id, record] : collider.triggersList) record.updatedThisFrame = false;
+            collidableIDs.push_back(entityID);
+        }
+
+        // Randomise l'ordre des entités pour créer un système moins biaisé
+        std::shuffle(
+            collidableIDs.begin(), 
+            collidableIDs.end(), 
+            mRandomEngine
+        );
+
+        // Les entités détruites, ou qui ont perdu leur collider, n'ont pas été mises à jour : elles quittent la broadphase
+        mDynamicBroadPhase->RemoveStale();
+        const std::vector<std::pair<EntityID, EntityID>>& candidates = GenerateBroadPhasePairs(*mDynamicBroadPhase, *mStaticBroadPhase);
 
         // LOG_DEBUG(std::string("NB COLLIDABLES " + collidableIDs.size()));
         // LOG_DEBUG(std::string("NB PAIRS " + candidates.size()));
@@ -121,23 +341,11 @@ namespace Engine::Physics {
                     record.duration += dt;
                     record.updatedThisFrame = true;
 
-                    if (GetRegistry().HasComponent<Behaviour>(aID)) {
-                        auto scripts = GetRegistry().GetComponents<Behaviour>(aID);
-                        for (auto script : scripts) {
-                            if (isTrigger) script->OnTriggerStay(cb.GetEntity(), manifold);
-                            else script->OnCollisionStay(cb.GetEntity(), manifold);
-                        }
-                    }
+                    mPendingEvents.push_back({aID, bID, manifold, isTrigger, CollisionEventType::Stay});
                 } else {
                     aRecords[bID] = {bID, 0.0f, isTrigger, true};
 
-                    if (GetRegistry().HasComponent<Behaviour>(aID)) {
-                        auto scripts = GetRegistry().GetComponents<Behaviour>(aID);
-                        for (auto script : scripts) {
-                            if (isTrigger) script->OnTriggerEnter(cb.GetEntity(), manifold);
-                            else script->OnCollisionEnter(cb.GetEntity(), manifold);
-                        }
-                    }
+                    mPendingEvents.push_back({aID, bID, manifold, isTrigger, CollisionEventType::Enter});
                 }
 
                 // B => A
@@ -146,25 +354,16 @@ namespace Engine::Physics {
                     record.duration += dt;
                     record.updatedThisFrame = true;
 
-                    if (GetRegistry().HasComponent<Behaviour>(bID)) {
-                        auto scripts = GetRegistry().GetComponents<Behaviour>(bID);
-                        for (auto script : scripts) {
-                            if (isTrigger) script->OnTriggerStay(ca.GetEntity(), manifold);
-                            else script->OnCollisionStay(ca.GetEntity(), manifold);
-                        }
-                    }
+                    mPendingEvents.push_back({bID, aID, manifold, isTrigger, CollisionEventType::Stay});
                 } else {
                     bRecords[aID] = {aID, 0.0f, isTrigger, true};
 
-                    if (GetRegistry().HasComponent<Behaviour>(bID)) {
-                        auto scripts = GetRegistry().GetComponents<Behaviour>(bID);
-                        for (auto script : scripts) {
-                            if (isTrigger) script->OnTriggerEnter(ca.GetEntity(), manifold);
-                            else script->OnCollisionEnter(ca.GetEntity(), manifold);
-                        }
-                    }
+                    mPendingEvents.push_back({bID, aID, manifold, isTrigger, CollisionEventType::Enter});
                 }
 
+                TrackStaticContact(aID);
+                TrackStaticContact(bID);
+
                 // Calcul de la vélocité selon la normale de la collision
                 glm::vec3 relativeVelocity = rb.velocity - ra.velocity;
                 float velAlongNormal = glm::dot(relativeVelocity, manifold.normal);
@@ -200,8 +399,8 @@ namespace Engine::Physics {
                     glm::vec3 moveA = -correction * (invMassA / invMassSum);
                     glm::vec3 moveB =  correction * (invMassB / invMassSum);
 
-                    if (!ra.isKinematic) ta.position += moveA;
-                    if (!rb.isKinematic) tb.position += moveB;
+                    if (!ra.isKinematic) ta.Translate(moveA);
+                    if (!rb.isKinematic) tb.Translate(moveB);
                 }
 
                 // Gestion du rebond si au moins un est bounceable
@@ -270,17 +469,7 @@ namespace Engine::Physics {
 
                         if (record.duration >= COLLISION_EXPIRE_THRESHOLD) {
                             toRemove.push_back(otherID);
-
-                            if (GetRegistry().HasComponent<Behaviour>(entityID)) {
-                                auto scripts = GetRegistry().GetComponents<Behaviour>(entityID);
-                                auto& otherCollider = GetRegistry().GetComponent<BoxCollider>(otherID);
-                                CollisionManifold dummyManifold{.colliding = false};
-
-                                for (auto script : scripts) {
-                                    if (isTrigger) script->OnTriggerExit(otherCollider.GetEntity(), dummyManifold);
-                                    else script->OnCollisionExit(otherCollider.GetEntity(), dummyManifold);
-                                }
-                            }
+                            mPendingEvents.push_back({entityID, otherID, CollisionManifold{.colliding = false}, isTrigger, CollisionEventType::Exit});
                         }
                     }
                 }
@@ -293,6 +482,48 @@ namespace Engine::Physics {
             cleanupRecords(collider.collisionsList, false);
             cleanupRecords(collider.triggersList, true);
         }
+
+        // Un collider statique sans collision en cours n'a plus besoin d'être parcouru
+        std::erase_if(mContactStatics, [&](EntityID entityID) {
+            auto& collider = registry.GetComponent<BoxCollider>(entityID);
+            if(!collider.collisionsList.empty() || !collider.triggersList.empty()) return false;
+
+            mBodies[EntityIndex(entityID)].inContact = false;
+            return true;
+        });
+
+        DispatchCollisionEvents();
+
+        // Les scripts appelés ci-dessus ont pu créer, détruire ou déplacer des colliders
+        SyncBodies();
+    }
+
+    void PhysicSystem::DispatchCollisionEvents() {
+        // Les scripts peuvent créer/détruire des entités : aucune référence vers un composant n'est gardée pendant les appels
+        for(const CollisionEvent& event : mPendingEvents) {
+            if(!GetRegistry().IsValidEntity(event.self) || !GetRegistry().HasComponent<Behaviour>(event.self)) continue;
+
+            ECS::Entity other(event.other, &GetRegistry());
+            GetRegistry().GetComponents<Behaviour>(event.self, mScripts);
+            for(auto script : mScripts) {
+                switch(event.type) {
+                    case CollisionEventType::Enter:
+                        if(event.isTrigger) script->OnTriggerEnter(other, event.manifold);
+                        else script->OnCollisionEnter(other, event.manifold);
+                        break;
+                    case CollisionEventType::Stay:
+                        if(event.isTrigger) script->OnTriggerStay(other, event.manifold);
+                        else script->OnCollisionStay(other, event.manifold);
+                        break;
+                    case CollisionEventType::Exit:
+                        if(event.isTrigger) script->OnTriggerExit(other, event.manifold);
+                        else script->OnCollisionExit(other, event.manifold);
+                        break;
+                }
+            }
+        }
+
+        mPendingEvents.clear();
     }
 
     CollisionManifold PhysicSystem::CheckAABBCollision(const AABB& a, const AABB& b) {
@@ -406,42 +637,28 @@ namespace Engine::Physics {
         return manifold;
     }
 
-    SpatialHash PhysicSystem::BuildSpatialHash(const std::vector<EntityID>& collidableIDs) {
-        SpatialHash output;
-        for(EntityID id : collidableIDs) {
-            auto& t = GetRegistry().GetComponent<Transform>(id);
-            auto& c = GetRegistry().GetComponent<BoxCollider>(id);
-            
-            // Mapping de la taille de l'aabb du collider selon la taille des cellules
-            // (Permet de ramener la position/taille du collider à un emplacement dans une ou plusieurs cellules de taille donnée)
-            int minX = floor((c.aabb.center.x - c.aabb.halfSize.x)/SPATIAL_HASH_CELL_SIZE);
-            int maxX = floor((c.aabb.center.x + c.aabb.halfSize.x)/SPATIAL_HASH_CELL_SIZE);
-            int minY = floor((c.aabb.center.y - c.aabb.halfSize.y)/SPATIAL_HASH_CELL_SIZE);
-            int maxY = floor((c.aabb.center.y + c.aabb.halfSize.y)/SPATIAL_HASH_CELL_SIZE);
-
-            // Pour chaque indice de cellule (entre la plus petite et la plus élevée) dans laquelle notre entité rentre, l'y ajouter.
-            for(int cx = minX; cx <= maxX; ++cx) {
-                for(int cy = minY; cy <= maxY; ++cy) {
-                    output[{(uint32_t)cx, (uint32_t)cy}].push_back(id);
-                }
-            }
-        }
-
-        return output;
-    }
+    const std::vector<std::pair<EntityID, EntityID>>& PhysicSystem::GenerateBroadPhasePairs(IBroadPhase& dynamicBroadPhase, IBroadPhase& staticBroadPhase) {
+        mPairKeys.clear();
 
-    std::vector<std::pair<EntityID, EntityID>> PhysicSystem::GenerateBroadPhasePairs(SpatialHash spatialHash) {
-        std::set<std::pair<EntityID, EntityID>> pairSet;
+        mBroadPhasePairs.clear();
+        dynamicBroadPhase.CollectPairs(mBroadPhasePairs);
+        for(auto [a, b] : mBroadPhasePairs) mPairKeys.push_back(PackPair(a, b));
 
-        for(auto& bucket : spatialHash) {
-            auto& vec = bucket.second;
-            for(size_t i = 0; i < vec.size(); ++i) {
-                for(size_t j = i + 1; j < vec.size(); ++j) {
-                    pairSet.insert({std::min(vec[i], vec[j]), std::max(vec[i], vec[j])});
-                }
-            }
+        // Chaque collider dynamique est comparé aux colliders statiques proches (jamais de paire statique/statique)
+        for(EntityID dynamicID : mDynamicIDs) {
+            const AABB& aabb = GetRegistry().GetComponent<BoxCollider>(dynamicID).aabb;
+            mQueryResults.clear();
+            staticBroadPhase.Query(aabb, mQueryResults);
+            for(EntityID staticID : mQueryResults) mPairKeys.push_back(PackPair(dynamicID, staticID));
         }
+        mGeneratedPairCount = mPairKeys.size();
+
+        // Tri puis suppression des doublons : les paires sont parcourues dans l'ordre de leurs IDs, comme avec un std::set
+        RadixSortKeys(mPairKeys, mPairKeysScratch);
+        mPairKeys.erase(std::unique(mPairKeys.begin(), mPairKeys.end()), mPairKeys.end());
 
-        return {pairSet.begin(), pairSet.end()};
+        mCandidatePairs.clear();
+        for(uint64_t key : mPairKeys) mCandidatePairs.push_back(UnpackPair(key));
+        return mCandidatePairs;
     }
 }
\ No newline at end of file
@@ -4,6 +4,11 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
 #include "../ecs/system.hpp"
 #include "../scene/transform.hpp"
 #include "../scene/behaviour.hpp"
@@ -11,7 +16,7 @@
 #include "rigidbody.hpp"
 #include "collider.hpp"
 #include "manifold.hpp"
-#include "spatialhash.hpp"
+#include "broadphase.hpp"
 #include "aabb.hpp"
 #include "obb.hpp"
 
@@ -24,6 +29,80 @@ namespace Engine::Physics {
      */
     class PhysicSystem : public ECS::System {
         private:
+            /** @brief Type d'évènement de collision à transmettre aux Behaviours */
+            enum class CollisionEventType { Enter, Stay, Exit };
+
+            /** @brief Un évènement de collision en attente, envoyé aux scripts une fois la résolution terminée */
+            struct CollisionEvent {
+                /** @brief L'entité dont les scripts reçoivent l'évènement */
+                EntityID self;
+                /** @brief L'entité avec laquelle la collision a lieu */
+                EntityID other;
+                CollisionManifold manifold;
+                bool isTrigger;
+                CollisionEventType type;
+            };
+
+            /** @brief Catégorie d'un collider dans la broadphase */
+            enum class BodyType : uint8_t { None, Static, Dynamic };
+
+            /** @brief Catégorie d'une entité, indexée par EntityIndex (voir SyncBodies) */
+            struct BodyEntry {
+                EntityID id = NULL_ENTITY;
+                BodyType type = BodyType::None;
+                /** @brief Position dans mDynamicIDs (corps dynamiques seulement) */
+                uint32_t dynamicIndex = 0;
+                /** @brief Vrai si le corps statique est dans mContactStatics */
+                bool inContact = false;
+            };
+
+            /** @brief Entités collidables du pas physique courant (tableau réutilisé d'un pas à l'autre) */
+            std::vector<EntityID> mCollidableIDs;
+            /**
+             * @brief Colliders dynamiques (rigidbodies non kinematic) : parcourus, recalculés et rangés à chaque pas
+             * 
+             * Les colliders statiques (rigidbodies kinematic : murs, sols, plateformes) ne sont rangés que dans mStaticBroadPhase,
+             * mis à jour seulement quand ils changent. Ils ne sont jamais comparés entre eux.
+             */
+            std::vector<EntityID> mDynamicIDs;
+            std::vector<BodyEntry> mBodies;
+            /** @brief Colliders statiques qui ont des collisions en cours : leurs records doivent vieillir à chaque pas */
+            std::vector<EntityID> mContactStatics;
+            /** @brief Entités à reclasser lors de la synchronisation (tableau réutilisé) */
+            std::vector<EntityID> mSyncIDs;
+            /** @brief Date de la dernière synchronisation des catégories de colliders */
+            ChangeTick mSyncTick = 0;
+            /** @brief Version de la hiérarchie lors de la dernière synchronisation (un changement de lien force une synchronisation complète) */
+            uint32_t mHierarchyVersion = 0;
+            /** @brief Si vrai, la prochaine synchronisation reclasse tous les colliders (chargement de scène) */
+            bool mNeedsFullSync = true;
+            /** @brief Scripts de l'entité qui reçoit un évènement de collision (tableau réutilisé) */
+            std::vector<Scene::Behaviour*> mScripts;
+            /**
+             * @brief Valeur du compteur de changements lors de la dernière mise à jour des AABB
+             * 
+             * Seuls les colliders dont le Transform ou le BoxCollider a changé depuis voient leur AABB recalculée.
+             */
+            ChangeTick mAABBTick = 0;
+            /** @brief Broadphase des colliders dynamiques, gardée d'un pas à l'autre (type choisi par la scène, voir Scene::SetBroadPhase) */
+            std::unique_ptr<IBroadPhase> mDynamicBroadPhase = CreateBroadPhase(BroadPhaseType::SpatialHash);
+            /** @brief Broadphase des colliders statiques, construite une fois puis mise à jour seulement quand ils changent */
+            std::unique_ptr<IBroadPhase> mStaticBroadPhase = CreateBroadPhase(BroadPhaseType::SpatialHash);
+            /** @brief Paires renvoyées par la broadphase dynamique (tableau réutilisé) */
+            std::vector<std::pair<EntityID, EntityID>> mBroadPhasePairs;
+            /** @brief Résultats des requêtes sur la broadphase statique (tableau réutilisé) */
+            std::vector<EntityID> mQueryResults;
+            /** @brief Clés (voir PackPair) de toutes les paires générées par la broadphase, doublons compris (tableau réutilisé) */
+            std::vector<uint64_t> mPairKeys;
+            /** @brief Tableau de travail du tri par base des clés */
+            std::vector<uint64_t> mPairKeysScratch;
+            /** @brief Paires candidates du pas courant, triées et sans doublons (tableau réutilisé) */
+            std::vector<std::pair<EntityID, EntityID>> mCandidatePairs;
+            /** @brief Nombre de paires générées par la broadphase lors du dernier pas, doublons compris */
+            size_t mGeneratedPairCount = 0;
+            /** @brief Générateur utilisé pour mélanger l'ordre de résolution des collisions */
+            std::mt19937 mRandomEngine{std::random_device{}()};
+
             int maxIterations = MAX_PHYSICS_ITERATIONS;
             double physicsTime = 0.0f;
 
@@ -34,6 +113,60 @@ namespace Engine::Physics {
              */
             glm::vec2 gravity = {0.0f, 9.81f};
 
+            /**
+             * @brief Recalcule l'AABB d'un collider à partir de son transform monde
+             * 
+             * @param transform 
+             * @param collider 
+             */
+            void RefreshAABB(Scene::Transform& transform, BoxCollider& collider);
+
+            /**
+             * @brief Reclasse les colliders ajoutés, retirés ou modifiés depuis la dernière synchronisation (statique, dynamique, aucun)
+             * 
+             * Le coût est proportionnel au nombre de changements. Appelé au début et à la fin du pas (après les évènements de collision).
+             * Les évènements postérieurs à mSyncTick sont gardés par le registre jusqu'à la synchronisation suivante (voir GetConsumedTick),
+             * même s'ils sont faits entre deux pas physiques (scripts, hooks de la scène).
+             */
+            void SyncBodies();
+            /**
+             * @brief Retire les corps dont l'entité ou les composants ont disparu sans que la synchronisation ne l'ait vu
+             * 
+             * Filet de sécurité avant les parcours du pas : aucun GetComponent n'est fait sur une entité qui n'est plus un collider.
+             */
+            void DropInvalidBodies();
+            /**
+             * @brief Vérifie que l'entité est valide et possède un Transform, un Rigidbody et un BoxCollider
+             * 
+             * @param entityID 
+             * @return true 
+             * @return false 
+             */
+            bool IsCollider(EntityID entityID);
+            /**
+             * @brief Range une entité dans la bonne catégorie, et met à jour la broadphase statique si c'est un collider statique
+             * 
+             * @param entityID 
+             */
+            void SyncBody(EntityID entityID);
+            /**
+             * @brief Retire un corps de sa catégorie actuelle
+             * 
+             * @param entry 
+             */
+            void RemoveBody(BodyEntry& entry);
+            /**
+             * @brief Note qu'un collider statique a des collisions en cours, pour faire vieillir ses records
+             * 
+             * @param entityID 
+             */
+            void TrackStaticContact(EntityID entityID);
+
+            /**
+             * @brief Garde la position et la rotation monde des rigidbodies avant le pas, pour l'interpolation du rendu
+             * 
+             */
+            void StorePreviousStates();
             /**
              * @brief Applique les mouvements et les lois de la dynamique à tous les objets
              * 
@@ -73,26 +206,65 @@ namespace Engine::Physics {
             glm::vec2 Reflect(const glm::vec2& velocity, const glm::vec2& normal);
 
             /**
-             * @brief Génération d'un spatial hash à partir d'entités données
+             * @brief Génère des paires d'entités pour lesquelles on doit checker les collisions
+             * Le tout en se basant sur le contenu des broadphases : paires dynamique/dynamique, puis dynamique/statique
              * 
-             * @param collidableIDs Les identifiants des entités que l'on considère comme collidables
-             * @return SpatialHash 
+             * Les paires sont rangées sous forme de clés 64 bits dans un tableau réutilisé, triées par base puis dédoublonnées :
+             * aucune allocation une fois les tableaux à la bonne taille.
+             * 
+             * @param dynamicBroadPhase
+             * @param staticBroadPhase
+             * @return const std::vector<std::pair<EntityID, EntityID>>& Les paires triées et sans doublons, valides jusqu'au prochain appel
              */
-            SpatialHash BuildSpatialHash(const std::vector<EntityID>& collidableIDs);
+            const std::vector<std::pair<EntityID, EntityID>>& GenerateBroadPhasePairs(IBroadPhase& dynamicBroadPhase, IBroadPhase& staticBroadPhase);
 
             /**
-             * @brief Génère des paires d'entités pour lesquelles on doit checker les collisions
-             * Le tout en se basant sur le contenu d'une spatialHash
+             * @brief Evènements de collision accumulés pendant le pas physique
              * 
-             * @return std::vector<std::pair<EntityID, EntityID>> 
+             * Les callbacks des Behaviours ne sont appelés qu'après la résolution : un script qui détruit ou créé une entité
+             * ne peut donc pas invalider les références vers les composants utilisées pendant la résolution.
              */
-            std::vector<std::pair<EntityID, EntityID>> GenerateBroadPhasePairs(SpatialHash spatialHash);
+            std::vector<CollisionEvent> mPendingEvents;
+
+            /**
+             * @brief Appelle les callbacks de collision/trigger des Behaviours pour tous les évènements en attente
+             * 
+             */
+            void DispatchCollisionEvents();
         public:        
+            /**
+             * @brief Appelé au chargement d'une scène : toutes les AABB du nouveau registre seront recalculées, et les broadphases du type choisi par la scène sont recréées
+             * 
+             */
+            void OnInit() override;
+
             /**
              * @brief Méthode de cycle de vie de l'app qui appelle les méthodes privées
              * 
              * @param deltaTime Temps passé depuis la dernière frame
              */
             void OnFixedUpdate(float deltaTime) override;
+
+            /**
+             * @brief Renvoie la date jusqu'à laquelle les évènements de composants ont été lus : la dernière synchronisation des corps
+             * 
+             * Les colliders ajoutés ou retirés entre deux pas physiques (update, scripts, hooks de la scène) restent visibles au pas suivant.
+             * 
+             * @return ChangeTick 
+             */
+            ChangeTick GetConsumedTick() const override { return std::min(ECS::System::GetConsumedTick(), mSyncTick); }
+
+            /**
+             * @brief Renvoie le nombre de paires générées par la broadphase lors du dernier pas (doublons compris)
+             * 
+             * @return size_t 
+             */
+            size_t GetGeneratedPairCount() const { return mGeneratedPairCount; }
+            /**
+             * @brief Renvoie le nombre de paires gardées après dédoublonnage lors du dernier pas (paires passées aux tests de collision)
+             * 
+             * @return size_t 
+             */
+            size_t GetKeptPairCount() const { return mCandidatePairs.size(); }
     };
 }
\ No newline at end of file
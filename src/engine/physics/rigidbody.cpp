@@ -16,4 +16,14 @@ namespace Engine::Physics {
     void Rigidbody::AddImpulse(const glm::vec3& impulsion) {
         if(mass > 0.0f) velocity += (impulsion / mass);
     }
+
+    glm::vec3 Rigidbody::InterpolatePosition(const glm::vec3& currentPosition, float alpha) const {
+        if(!interpolate || isKinematic || !hasPreviousState) return currentPosition;
+        return glm::mix(previousPosition, currentPosition, alpha);
+    }
+
+    glm::quat Rigidbody::InterpolateRotation(const glm::quat& currentRotation, float alpha) const {
+        if(!interpolate || isKinematic || !hasPreviousState) return currentRotation;
+        return glm::slerp(previousRotation, currentRotation, alpha);
+    }
 }
\ No newline at end of file
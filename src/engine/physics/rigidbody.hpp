@@ -5,6 +5,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include "../ecs/component.hpp"
 
 namespace Engine::Physics {
@@ -41,6 +42,20 @@ namespace Engine::Physics {
         /** @brief temps passé en étant immobile. Au dela d'un certain seuil, le rigidbody passe en mode "sleep" pour économiser des ressources */
         float sleepTimer = 0.0f;
 
+        /**
+         * @brief Si vrai => Le rendu interpole entre l'état du pas physique précédent et l'état courant
+         * 
+         * Lisse l'affichage quand l'écran rafraîchit plus vite que la boucle FixedUpdate (voir AppSettings::fixedStepFramerate).
+         * Ignoré pour les objets kinematic, déplacés à la main à chaque frame.
+         */
+        bool interpolate            = true;
+        /** @brief Position monde au début du dernier pas physique (mise à jour par PhysicSystem) */
+        glm::vec3 previousPosition  = {0.0f, 0.0f, 0.0f};
+        /** @brief Rotation monde au début du dernier pas physique (mise à jour par PhysicSystem) */
+        glm::quat previousRotation  = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        /** @brief Si vrai => previousPosition et previousRotation sont valides (faux jusqu'au premier pas physique, ou après une téléportation) */
+        bool hasPreviousState       = false;
+
         /** @brief Si vrai => Inidque que l'objet est posé à même le sol (ne chute pas) */
         bool onGround               = false;
         /** @brief Si vrai => Indique que l'objet est posé contre un mur */
@@ -71,5 +86,28 @@ namespace Engine::Physics {
          * @param impulsion 
          */
         void AddImpulse(const glm::vec3& impulsion);
+
+        /**
+         * @brief Oublie l'état du pas précédent : à appeler après avoir téléporté l'objet, pour ne pas interpoler le saut
+         * 
+         */
+        void ResetInterpolation() { hasPreviousState = false; }
+
+        /**
+         * @brief Renvoie la position à afficher entre le pas physique précédent et l'état courant
+         * 
+         * @param currentPosition La position monde courante
+         * @param alpha La fraction de pas écoulée depuis le dernier pas physique (0 => pas précédent, 1 => état courant)
+         * @return glm::vec3 
+         */
+        glm::vec3 InterpolatePosition(const glm::vec3& currentPosition, float alpha) const;
+        /**
+         * @brief Renvoie la rotation à afficher entre le pas physique précédent et l'état courant
+         * 
+         * @param currentRotation La rotation monde courante
+         * @param alpha La fraction de pas écoulée depuis le dernier pas physique (0 => pas précédent, 1 => état courant)
+         * @return glm::quat 
+         */
+        glm::quat InterpolateRotation(const glm::quat& currentRotation, float alpha) const;
     };
 }
\ No newline at end of file
@@ -1,11 +1,201 @@
 #include "spatialhash.hpp"
 
+#include <cmath>
+#include <algorithm>
+
 namespace Engine::Physics {
-    size_t CellHash::operator()(Cell c) const {
-        return std::hash<uint64_t>()(((uint64_t)c.x<<32) ^ (uint64_t)c.y);
+    namespace {
+        /** @brief Taille initiale de la table (puissance de 2) */
+        constexpr size_t INITIAL_SLOT_COUNT = 64;
+
+        /** @brief Mélange de Fibonacci : répartit les clés voisines dans toute la table */
+        inline size_t HashKey(uint64_t key, size_t mask) {
+            return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        }
     }
 
     bool operator==(const Cell& a, const Cell& b) {
         return a.x == b.x && a.y == b.y;
     }
-}
\ No newline at end of file
+
+    uint64_t PackCell(Cell c) {
+        return ((uint64_t)(uint32_t)c.x << 32) | (uint64_t)(uint32_t)c.y;
+    }
+
+    SpatialHash::SpatialHash(float cellSize) : mCellSize(cellSize), mSlots(INITIAL_SLOT_COUNT) {}
+
+    size_t SpatialHash::FindSlot(uint64_t key) const {
+        size_t mask = mSlots.size() - 1;
+        size_t slot = HashKey(key, mask);
+        while(mSlots[slot].bucket != EMPTY_SLOT && mSlots[slot].key != key) slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    uint32_t SpatialHash::GetOrCreateBucket(Cell cell) {
+        uint64_t key = PackCell(cell);
+        size_t slot = FindSlot(key);
+        if(mSlots[slot].bucket != EMPTY_SLOT) return mSlots[slot].bucket;
+
+        // Facteur de charge maximal de 1/2 : au-delà, le sondage linéaire se dégrade
+        if((mBuckets.size() + 1) * 2 > mSlots.size()) {
+            Rehash();
+            slot = FindSlot(key);
+        }
+
+        uint32_t bucket = static_cast<uint32_t>(mBuckets.size());
+        mBuckets.push_back({key, {}});
+        mSlots[slot] = {key, bucket};
+        return bucket;
+    }
+
+    void SpatialHash::Rehash() {
+        // Les cellules vides sont oubliées, les autres sont renumérotées dans le même ordre
+        std::vector<Bucket> buckets;
+        buckets.reserve(mActiveBuckets.size() + 1);
+        for(Bucket& bucket : mBuckets) {
+            if(bucket.entities.empty()) continue;
+            buckets.push_back(std::move(bucket));
+        }
+        mBuckets = std::move(buckets);
+
+        size_t slotCount = INITIAL_SLOT_COUNT;
+        while((mBuckets.size() + 1) * 4 > slotCount) slotCount *= 2;
+        mSlots.assign(slotCount, Slot{});
+
+        mActiveBuckets.clear();
+        for(uint32_t bucket = 0; bucket < mBuckets.size(); ++bucket) {
+            mSlots[FindSlot(mBuckets[bucket].key)] = {mBuckets[bucket].key, bucket};
+            mBuckets[bucket].activeIndex = static_cast<uint32_t>(mActiveBuckets.size());
+            mActiveBuckets.push_back(bucket);
+        }
+    }
+
+    Cell SpatialHash::GetCell(const glm::vec2& point) const {
+        return {static_cast<int32_t>(std::floor(point.x / mCellSize)), static_cast<int32_t>(std::floor(point.y / mCellSize))};
+    }
+
+    void SpatialHash::InsertProxy(const Proxy& proxy) {
+        // Pour chaque indice de cellule (entre la plus petite et la plus élevée) dans laquelle notre entité rentre, l'y ajouter.
+        for(int32_t cx = proxy.min.x; cx <= proxy.max.x; ++cx) {
+            for(int32_t cy = proxy.min.y; cy <= proxy.max.y; ++cy) {
+                uint32_t index = GetOrCreateBucket({cx, cy});
+                Bucket& bucket = mBuckets[index];
+                if(bucket.entities.empty()) {
+                    bucket.activeIndex = static_cast<uint32_t>(mActiveBuckets.size());
+                    mActiveBuckets.push_back(index);
+                }
+                bucket.entities.push_back(proxy.id);
+            }
+        }
+    }
+
+    void SpatialHash::RemoveProxy(const Proxy& proxy) {
+        for(int32_t cx = proxy.min.x; cx <= proxy.max.x; ++cx) {
+            for(int32_t cy = proxy.min.y; cy <= proxy.max.y; ++cy) {
+                size_t slot = FindSlot(PackCell({cx, cy}));
+                if(mSlots[slot].bucket == EMPTY_SLOT) continue;
+
+                Bucket& bucket = mBuckets[mSlots[slot].bucket];
+                auto it = std::find(bucket.entities.begin(), bucket.entities.end(), proxy.id);
+                if(it == bucket.entities.end()) continue;
+
+                *it = bucket.entities.back();
+                bucket.entities.pop_back();
+
+                // Cellule vidée : elle quitte la liste des cellules occupées (swap and pop) mais garde sa mémoire
+                if(bucket.entities.empty()) {
+                    uint32_t moved = mActiveBuckets.back();
+                    mActiveBuckets[bucket.activeIndex] = moved;
+                    mBuckets[moved].activeIndex = bucket.activeIndex;
+                    mActiveBuckets.pop_back();
+                    bucket.activeIndex = EMPTY_SLOT;
+                }
+            }
+        }
+    }
+
+    void SpatialHash::Update(EntityID entityID, const AABB& aabb) {
+        Cell min = GetCell(aabb.Min());
+        Cell max = GetCell(aabb.Max());
+
+        uint32_t entityIndex = EntityIndex(entityID);
+        if(entityIndex >= mProxyIndex.size()) mProxyIndex.resize(entityIndex + 1, EMPTY_SLOT);
+
+        uint32_t index = mProxyIndex[entityIndex];
+        if(index != EMPTY_SLOT && mProxies[index].id != entityID) {
+            // L'index a été recyclé par une nouvelle entité : l'ancienne quitte la grille
+            Remove(mProxies[index].id);
+            index = EMPTY_SLOT;
+        }
+
+        if(index == EMPTY_SLOT) {
+            mProxyIndex[entityIndex] = static_cast<uint32_t>(mProxies.size());
+            mProxies.push_back({entityID, min, max, mStamp});
+            InsertProxy(mProxies.back());
+            return;
+        }
+
+        Proxy& proxy = mProxies[index];
+        proxy.stamp = mStamp;
+        if(proxy.min == min && proxy.max == max) return;
+
+        RemoveProxy(proxy);
+        proxy.min = min;
+        proxy.max = max;
+        InsertProxy(proxy);
+    }
+
+    void SpatialHash::Remove(EntityID entityID) {
+        uint32_t entityIndex = EntityIndex(entityID);
+        if(entityIndex >= mProxyIndex.size()) return;
+
+        uint32_t index = mProxyIndex[entityIndex];
+        if(index == EMPTY_SLOT || mProxies[index].id != entityID) return;
+
+        RemoveProxy(mProxies[index]);
+
+        // Swap and pop dans le tableau des proxies
+        mProxies[index] = mProxies.back();
+        mProxyIndex[EntityIndex(mProxies[index].id)] = index;
+        mProxies.pop_back();
+        mProxyIndex[entityIndex] = EMPTY_SLOT;
+    }
+
+    void SpatialHash::RemoveStale() {
+        for(size_t i = mProxies.size(); i-- > 0;) {
+            if(mProxies[i].stamp != mStamp) Remove(mProxies[i].id);
+        }
+        ++mStamp;
+    }
+
+    void SpatialHash::CollectPairs(std::vector<std::pair<EntityID, EntityID>>& out) {
+        ForEachCell([&](const std::vector<EntityID>& entities) {
+            for(size_t i = 0; i < entities.size(); ++i) {
+                for(size_t j = i + 1; j < entities.size(); ++j) out.emplace_back(entities[i], entities[j]);
+            }
+        });
+    }
+
+    void SpatialHash::Query(const AABB& aabb, std::vector<EntityID>& out) {
+        if(mProxies.empty()) return;
+
+        Cell min = GetCell(aabb.Min());
+        Cell max = GetCell(aabb.Max());
+        for(int32_t cx = min.x; cx <= max.x; ++cx) {
+            for(int32_t cy = min.y; cy <= max.y; ++cy) {
+                const Slot& slot = mSlots[FindSlot(PackCell({cx, cy}))];
+                if(slot.bucket == EMPTY_SLOT) continue;
+                out.insert(out.end(), mBuckets[slot.bucket].entities.begin(), mBuckets[slot.bucket].entities.end());
+            }
+        }
+    }
+
+    void SpatialHash::Clear() {
+        mSlots.assign(INITIAL_SLOT_COUNT, Slot{});
+        mBuckets.clear();
+        mActiveBuckets.clear();
+        mProxies.clear();
+        mProxyIndex.clear();
+        mStamp = 0;
+    }
+}
@@ -7,14 +7,19 @@
  * 
  * Les objets qui ne sont pas dans la même cellule ne sont pas comparés lors de la résolution du système physique, on considère qu'ils sont trop éloignés.
  * Ca évite de faire les checks de collisions plus complexes sur des objets éloignés qui ne sont de toute évidence pas en contact.
+ * 
+ * Le spatial hash est persistant : une entité n'est déplacée que lorsque son AABB change de cellules,
+ * et les cellules gardent leur mémoire d'un pas physique à l'autre.
  */
 #pragma once
 
-#include <bitset>
+#include <cstdint>
 #include <vector>
-#include <unordered_map>
 
 #include "../defs.hpp"
+#include "../constants.hpp"
+#include "aabb.hpp"
+#include "broadphase.hpp"
 
 namespace Engine::Physics {
     /**
@@ -22,33 +27,196 @@ namespace Engine::Physics {
      * 
      * X et Y sont la position de la cellule en "indices" pas en pixels.
      */
-    struct Cell { uint32_t x, y; };
-    
+    struct Cell { int32_t x, y; };
+
     /**
      * @brief Surcharge de l'opérateur de test d'égalité pour les cellules
      * 
      * @param a Cellule A
      * @param b Cellule B
-     * @return true 
-     * @return false 
+     * @return true
+     * @return false
      */
     bool operator==(const Cell& a, const Cell& b);
 
     /**
-     * @brief Le hash d'une cellule donnée
+     * @brief Renvoie la clé d'une cellule : X et Y placés l'un derrière l'autre dans un entier de 64 bits
      * 
-     * Il est généré à partir de la position de la cellule (X, Y)
-     * On génère un entier de 64 bits dans lequel X et Y sont placés l'un derrière l'autre pour obtenir une signature unique.
-     * X et Y faisant chacun 32 bits au maximum
+     * @param c
+     * @return uint64_t
      */
-    struct CellHash {
-        size_t operator()(Cell c) const;
-    };
+    uint64_t PackCell(Cell c);
 
     /**
-     * @brief Défiinition du "type" spatialHash => simplement une unordered_map qui lit des entités à une cellule
+     * @brief Grille persistante qui range les entités par cellule, à partir de leurs AABB
      * 
-     * On précise aussi que l'unordered_map doit hasher les cellules en utilisant le CellHash que l'on a définit
+     * Les cellules sont retrouvées par une table à adressage ouvert (sondage linéaire) indexée par la clé de la cellule.
+     * Les cellules vidées restent dans la table et gardent leur mémoire : elles ne sont retirées que lorsque la table est reconstruite.
      */
-    using SpatialHash = std::unordered_map<Cell, std::vector<Engine::EntityID>, CellHash>;
+    class SpatialHash : public IBroadPhase {
+        private:
+            /** @brief Valeur d'un emplacement vide dans la table */
+            static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+            /** @brief Une entrée de la table : la clé de la cellule et l'index de son bucket */
+            struct Slot {
+                uint64_t key = 0;
+                uint32_t bucket = EMPTY_SLOT;
+            };
+
+            /** @brief Les entités d'une cellule */
+            struct Bucket {
+                uint64_t key;
+                std::vector<EntityID> entities;
+                /** @brief Position du bucket dans mActiveBuckets (EMPTY_SLOT s'il est vide) */
+                uint32_t activeIndex = EMPTY_SLOT;
+            };
+
+            /** @brief Une entité de la grille et le rectangle de cellules qu'elle occupe */
+            struct Proxy {
+                EntityID id;
+                Cell min, max;
+                /** @brief Valeur de mStamp lors du dernier Update de l'entité */
+                uint32_t stamp;
+            };
+
+            float mCellSize;
+
+            std::vector<Slot> mSlots;
+            std::vector<Bucket> mBuckets;
+            /** @brief Index des buckets non vides, pour ne parcourir que les cellules occupées */
+            std::vector<uint32_t> mActiveBuckets;
+
+            /** @brief Proxies rangés de manière contiguë */
+            std::vector<Proxy> mProxies;
+            /** @brief Index d'entité => position dans mProxies (EMPTY_SLOT si l'entité n'est pas dans la grille) */
+            std::vector<uint32_t> mProxyIndex;
+            uint32_t mStamp = 0;
+
+            /**
+             * @brief Renvoie l'emplacement de la table où se trouve (ou devrait se trouver) la clé
+             * 
+             * @param key
+             * @return size_t
+             */
+            size_t FindSlot(uint64_t key) const;
+
+            /**
+             * @brief Renvoie le bucket de la cellule, créé s'il n'existe pas encore
+             * 
+             * @param cell
+             * @return uint32_t
+             */
+            uint32_t GetOrCreateBucket(Cell cell);
+
+            /**
+             * @brief Reconstruit la table : les cellules vides sont oubliées, et la table grandit si elle est trop remplie
+             * 
+             */
+            void Rehash();
+
+            /**
+             * @brief Range l'entité dans les cellules de son proxy
+             * 
+             * @param proxy
+             */
+            void InsertProxy(const Proxy& proxy);
+            /**
+             * @brief Retire l'entité des cellules de son proxy
+             * 
+             * @param proxy
+             */
+            void RemoveProxy(const Proxy& proxy);
+
+            /**
+             * @brief Renvoie la cellule qui contient le point
+             * 
+             * @param point
+             * @return Cell
+             */
+            Cell GetCell(const glm::vec2& point) const;
+
+        public:
+            /**
+             * @brief Construit une grille vide
+             * 
+             * @param cellSize Taille d'une cellule (en unités du monde)
+             */
+            explicit SpatialHash(float cellSize = SPATIAL_HASH_CELL_SIZE);
+
+            /**
+             * @brief Ajoute l'entité à la grille, ou met à jour ses cellules
+             * 
+             * Si l'AABB couvre les mêmes cellules qu'au dernier appel, rien n'est déplacé.
+             * 
+             * @param entityID
+             * @param aabb
+             */
+            void Update(EntityID entityID, const AABB& aabb) override;
+
+            /**
+             * @brief Retire l'entité de la grille (sans effet si elle n'y est pas)
+             * 
+             * @param entityID
+             */
+            void Remove(EntityID entityID) override;
+
+            /**
+             * @brief Retire les entités qui n'ont pas été mises à jour depuis le dernier appel à RemoveStale
+             * 
+             * Appelé une fois par pas physique, après l'Update de tous les colliders : les entités détruites
+             * (ou qui ont perdu leur collider) quittent ainsi la grille sans avoir à être signalées.
+             */
+            void RemoveStale() override;
+
+            /**
+             * @brief Vide la grille (la mémoire des cellules est libérée)
+             * 
+             */
+            void Clear() override;
+
+            /**
+             * @brief Appelle func(entities) pour chaque cellule occupée
+             * 
+             * @tparam Func
+             * @param func func(const std::vector<EntityID>&)
+             */
+            template<typename Func>
+            void ForEachCell(Func&& func) const {
+                for(uint32_t bucket : mActiveBuckets) func(mBuckets[bucket].entities);
+            }
+
+            /**
+             * @brief Ajoute à out toutes les paires d'entités qui partagent une cellule
+             * 
+             * Deux entités qui partagent plusieurs cellules forment plusieurs fois la même paire.
+             * 
+             * @param out 
+             */
+            void CollectPairs(std::vector<std::pair<EntityID, EntityID>>& out) override;
+
+            /**
+             * @brief Ajoute à out chaque entité rangée dans une des cellules couvertes par l'AABB
+             * 
+             * Une entité qui occupe plusieurs de ces cellules est ajoutée plusieurs fois.
+             * 
+             * @param aabb 
+             * @param out 
+             */
+            void Query(const AABB& aabb, std::vector<EntityID>& out) override;
+
+            /**
+             * @brief Renvoie le nombre d'entités de la grille
+             * 
+             * @return size_t
+             */
+            size_t Size() const override { return mProxies.size(); }
+
+            /**
+             * @brief Renvoie le nombre de cellules occupées
+             * 
+             * @return size_t
+             */
+            size_t GetCellCount() const { return mActiveBuckets.size(); }
+    };
 }
@@ -0,0 +1,186 @@
+#include "sweepandprune.hpp"
+
+#include <algorithm>
+
+namespace Engine::Physics {
+    bool SweepAndPrune::Less(const Endpoint& a, const Endpoint& b) {
+        // A valeur égale, la borne de début passe avant la borne de fin : deux AABB qui se touchent forment une paire
+        return a.value < b.value || (a.value == b.value && !a.IsMax() && b.IsMax());
+    }
+
+    void SweepAndPrune::Sort() {
+        if(mRemovedCount > 0) Compact();
+        if(mSorted) return;
+
+        if(mAppendedCount * 4 > mEndpoints.size()) {
+            // Beaucoup de nouvelles bornes (chargement de scène) : le tableau n'est plus presque trié
+            std::sort(mEndpoints.begin(), mEndpoints.end(), Less);
+        } else {
+            // Tri par insertion : chaque borne ne recule que des quelques places gagnées depuis le pas précédent
+            for(size_t i = 1; i < mEndpoints.size(); ++i) {
+                Endpoint endpoint = mEndpoints[i];
+                size_t j = i;
+                while(j > 0 && Less(endpoint, mEndpoints[j - 1])) {
+                    mEndpoints[j] = mEndpoints[j - 1];
+                    --j;
+                }
+                mEndpoints[j] = endpoint;
+            }
+        }
+
+        for(uint32_t i = 0; i < mEndpoints.size(); ++i) {
+            mProxies[mEndpoints[i].Proxy()].endpoints[mEndpoints[i].IsMax()] = i;
+        }
+
+        mMaxWidth = 0.0f;
+        for(const Proxy& proxy : mProxies) mMaxWidth = std::max(mMaxWidth, proxy.max.x - proxy.min.x);
+
+        mAppendedCount = 0;
+        mSorted = true;
+    }
+
+    void SweepAndPrune::Compact() {
+        // Les proxies restants sont tassés au début du tableau, dans le même ordre
+        mRemap.resize(mProxies.size());
+        uint32_t count = 0;
+        for(uint32_t i = 0; i < mProxies.size(); ++i) {
+            if(mProxies[i].id == NULL_ENTITY) {
+                mRemap[i] = EMPTY_PROXY;
+                continue;
+            }
+            mRemap[i] = count;
+            mProxies[count] = mProxies[i];
+            mProxyIndex[EntityIndex(mProxies[count].id)] = count;
+            ++count;
+        }
+        mProxies.resize(count);
+
+        // Les bornes des proxies retirés sont sautées : l'ordre des autres ne change pas
+        size_t written = 0;
+        for(Endpoint endpoint : mEndpoints) {
+            uint32_t proxy = mRemap[endpoint.Proxy()];
+            if(proxy == EMPTY_PROXY) continue;
+
+            endpoint.data = (proxy << 1) | (endpoint.data & 1);
+            mProxies[proxy].endpoints[endpoint.IsMax()] = static_cast<uint32_t>(written);
+            mEndpoints[written++] = endpoint;
+        }
+        mEndpoints.resize(written);
+        mRemovedCount = 0;
+    }
+
+    void SweepAndPrune::Update(EntityID entityID, const AABB& aabb) {
+        glm::vec2 min = aabb.Min();
+        glm::vec2 max = aabb.Max();
+
+        uint32_t entityIndex = EntityIndex(entityID);
+        if(entityIndex >= mProxyIndex.size()) mProxyIndex.resize(entityIndex + 1, EMPTY_PROXY);
+
+        uint32_t index = mProxyIndex[entityIndex];
+        if(index != EMPTY_PROXY && mProxies[index].id != entityID) {
+            // L'index a été recyclé par une nouvelle entité : l'ancienne quitte la broadphase
+            Remove(mProxies[index].id);
+            index = EMPTY_PROXY;
+        }
+
+        if(index == EMPTY_PROXY) {
+            index = static_cast<uint32_t>(mProxies.size());
+            uint32_t first = static_cast<uint32_t>(mEndpoints.size());
+            mProxyIndex[entityIndex] = index;
+            mProxies.push_back({entityID, min, max, {first, first + 1}, mStamp});
+            mEndpoints.push_back({min.x, index << 1});
+            mEndpoints.push_back({max.x, (index << 1) | 1});
+            mAppendedCount += 2;
+            mSorted = false;
+            return;
+        }
+
+        Proxy& proxy = mProxies[index];
+        proxy.stamp = mStamp;
+        proxy.min = min;
+        proxy.max = max;
+
+        Endpoint& begin = mEndpoints[proxy.endpoints[0]];
+        Endpoint& end = mEndpoints[proxy.endpoints[1]];
+        if(begin.value == min.x && end.value == max.x) return;
+
+        begin.value = min.x;
+        end.value = max.x;
+        mSorted = false;
+    }
+
+    void SweepAndPrune::Remove(EntityID entityID) {
+        uint32_t entityIndex = EntityIndex(entityID);
+        if(entityIndex >= mProxyIndex.size()) return;
+
+        uint32_t index = mProxyIndex[entityIndex];
+        if(index == EMPTY_PROXY || mProxies[index].id != entityID) return;
+
+        mProxies[index].id = NULL_ENTITY;
+        mProxyIndex[entityIndex] = EMPTY_PROXY;
+        ++mRemovedCount;
+    }
+
+    void SweepAndPrune::RemoveStale() {
+        for(Proxy& proxy : mProxies) {
+            if(proxy.id == NULL_ENTITY || proxy.stamp == mStamp) continue;
+            mProxyIndex[EntityIndex(proxy.id)] = EMPTY_PROXY;
+            proxy.id = NULL_ENTITY;
+            ++mRemovedCount;
+        }
+        if(mRemovedCount > 0) Compact();
+        ++mStamp;
+    }
+
+    void SweepAndPrune::Clear() {
+        mEndpoints.clear();
+        mProxies.clear();
+        mProxyIndex.clear();
+        mSorted = true;
+        mAppendedCount = 0;
+        mRemovedCount = 0;
+        mMaxWidth = 0.0f;
+        mStamp = 0;
+    }
+
+    void SweepAndPrune::CollectPairs(std::vector<std::pair<EntityID, EntityID>>& out) {
+        Sort();
+
+        // Balayage : une entité entre dans la liste active à sa borne de début et en sort à sa borne de fin.
+        // Elle n'est comparée (sur Y) qu'aux entités actives, les seules qui la chevauchent sur X.
+        mActive.clear();
+        for(const Endpoint& endpoint : mEndpoints) {
+            uint32_t index = endpoint.Proxy();
+            if(endpoint.IsMax()) {
+                auto it = std::find(mActive.begin(), mActive.end(), index);
+                *it = mActive.back();
+                mActive.pop_back();
+                continue;
+            }
+
+            const Proxy& proxy = mProxies[index];
+            for(uint32_t other : mActive) {
+                const Proxy& active = mProxies[other];
+                if(proxy.min.y <= active.max.y && active.min.y <= proxy.max.y) out.emplace_back(active.id, proxy.id);
+            }
+            mActive.push_back(index);
+        }
+    }
+
+    void SweepAndPrune::Query(const AABB& aabb, std::vector<EntityID>& out) {
+        Sort();
+
+        glm::vec2 min = aabb.Min();
+        glm::vec2 max = aabb.Max();
+
+        // Aucune AABB n'est plus large que mMaxWidth : celles qui commencent avant min.x - mMaxWidth ne peuvent pas atteindre min.x
+        Endpoint first{min.x - mMaxWidth, 0};
+        auto it = std::lower_bound(mEndpoints.begin(), mEndpoints.end(), first, Less);
+        for(; it != mEndpoints.end() && it->value <= max.x; ++it) {
+            if(it->IsMax()) continue;
+
+            const Proxy& proxy = mProxies[it->Proxy()];
+            if(proxy.max.x >= min.x && proxy.min.y <= max.y && min.y <= proxy.max.y) out.push_back(proxy.id);
+        }
+    }
+}
@@ -0,0 +1,149 @@
+/**
+ * @file sweepandprune.hpp
+ * @brief Définit une broadphase "sweep and prune" : les AABB sont triées sur l'axe X et balayées de gauche à droite
+ * 
+ * Chaque entité est représentée par deux bornes (début et fin de son AABB sur X) rangées dans un tableau trié.
+ * Le tableau est gardé d'un pas à l'autre : comme les entités bougent peu entre deux pas, il est presque trié
+ * et un tri par insertion le remet en ordre en un temps quasi linéaire.
+ * 
+ * Le balayage ne compare que les entités dont les intervalles sur X se chevauchent : c'est efficace pour les niveaux
+ * horizontaux (side-scrolling), beaucoup moins si les colliders sont empilés sur une même colonne.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../defs.hpp"
+#include "aabb.hpp"
+#include "broadphase.hpp"
+
+namespace Engine::Physics {
+    /**
+     * @brief Broadphase par tri et balayage sur l'axe X, avec cohérence temporelle
+     * 
+     * Les entités retirées sont seulement marquées : leurs bornes quittent le tableau en une seule passe, au prochain tri.
+     */
+    class SweepAndPrune : public IBroadPhase {
+        private:
+            /** @brief Valeur de mProxyIndex pour une entité absente de la broadphase */
+            static constexpr uint32_t EMPTY_PROXY = UINT32_MAX;
+
+            /** @brief Une borne d'une AABB sur X */
+            struct Endpoint {
+                float value;
+                /** @brief Index du proxy décalé d'un bit, le bit de poids faible vaut 1 pour la borne de fin */
+                uint32_t data;
+
+                uint32_t Proxy() const { return data >> 1; }
+                bool IsMax() const { return data & 1; }
+            };
+
+            /** @brief Une entité de la broadphase */
+            struct Proxy {
+                EntityID id;
+                glm::vec2 min, max;
+                /** @brief Position de ses bornes (début, fin) dans mEndpoints */
+                uint32_t endpoints[2];
+                /** @brief Valeur de mStamp lors du dernier Update de l'entité */
+                uint32_t stamp;
+            };
+
+            /** @brief Bornes de toutes les entités, triées sur X (sauf si mSorted est faux) */
+            std::vector<Endpoint> mEndpoints;
+            /** @brief Faux si des bornes ont été ajoutées ou déplacées depuis le dernier tri */
+            bool mSorted = true;
+            /** @brief Nombre de bornes ajoutées à la fin du tableau depuis le dernier tri */
+            size_t mAppendedCount = 0;
+            /** @brief Nombre de proxies marqués comme retirés, pas encore sortis du tableau (voir Compact) */
+            size_t mRemovedCount = 0;
+            /** @brief Plus grande largeur d'AABB sur X, pour savoir d'où commencer le parcours d'une requête */
+            float mMaxWidth = 0.0f;
+
+            std::vector<Proxy> mProxies;
+            /** @brief Index d'entité => position dans mProxies (EMPTY_PROXY si l'entité n'est pas dans la broadphase) */
+            std::vector<uint32_t> mProxyIndex;
+            uint32_t mStamp = 0;
+
+            /** @brief Proxies dont l'intervalle sur X contient la position courante du balayage (tableau réutilisé) */
+            std::vector<uint32_t> mActive;
+            /** @brief Nouvelle position des proxies lors d'un compactage (tableau réutilisé) */
+            std::vector<uint32_t> mRemap;
+
+            /**
+             * @brief Ordre des bornes dans mEndpoints
+             * 
+             * @param a
+             * @param b
+             * @return true si a passe avant b
+             */
+            static bool Less(const Endpoint& a, const Endpoint& b);
+
+            /**
+             * @brief Sort les proxies retirés du tableau, retrie les bornes si besoin, et remet à jour la position des bornes dans les proxies
+             * 
+             * Tri par insertion si le tableau est presque trié, tri complet si beaucoup de bornes viennent d'être ajoutées.
+             */
+            void Sort();
+
+            /**
+             * @brief Retire les proxies marqués (id à NULL_ENTITY) et leurs bornes, sans casser l'ordre du tableau
+             * 
+             */
+            void Compact();
+
+        public:
+            /**
+             * @brief Ajoute l'entité à la broadphase, ou met à jour ses bornes
+             * 
+             * Le tableau n'est retrié qu'au prochain CollectPairs ou Query.
+             * 
+             * @param entityID
+             * @param aabb
+             */
+            void Update(EntityID entityID, const AABB& aabb) override;
+
+            /**
+             * @brief Retire l'entité de la broadphase (sans effet si elle n'y est pas)
+             * 
+             * L'entité est seulement marquée : ses bornes sont retirées au prochain tri, en même temps que celles des autres entités retirées.
+             * 
+             * @param entityID
+             */
+            void Remove(EntityID entityID) override;
+
+            /**
+             * @brief Retire les entités qui n'ont pas été mises à jour depuis le dernier appel à RemoveStale
+             * 
+             */
+            void RemoveStale() override;
+
+            /**
+             * @brief Vide la broadphase
+             * 
+             */
+            void Clear() override;
+
+            /**
+             * @brief Renvoie le nombre d'entités de la broadphase
+             * 
+             * @return size_t
+             */
+            size_t Size() const override { return mProxies.size() - mRemovedCount; }
+
+            /**
+             * @brief Balaye les bornes triées, et ajoute à out les paires dont les AABB se touchent (chaque paire une seule fois)
+             * 
+             * @param out
+             */
+            void CollectPairs(std::vector<std::pair<EntityID, EntityID>>& out) override;
+
+            /**
+             * @brief Ajoute à out les entités dont l'AABB touche celle passée en paramètre
+             * 
+             * @param aabb
+             * @param out
+             */
+            void Query(const AABB& aabb, std::vector<EntityID>& out) override;
+    };
+}
@@ -132,28 +132,23 @@ namespace Engine::Render {
         mDebugShader->SetMat4("u_Projection", mainCamera->GetProjectionMatrix());
         mDebugShader->SetMat4("u_View", mainCamera->GetViewMatrix());
         
-        for (auto entityID : GetRegistry().GetEntityIDsWith<Transform>()) {
-            const auto& tf = GetRegistry().GetComponent<Transform>(entityID);
+        for (auto [entityID, tf] : GetRegistry().View<const Transform>()) {
             if(!(tf.enabled)) continue;
 
             if(!(GetRegistry().HasComponent<Text>(entityID) || GetRegistry().HasComponent<Element>(entityID)))
                 DrawCross(tf.GetWorldPosition(), 10.f, 2.0f, Utils::Colors::BLACK);
         }
 
-        for (auto entityID : GetRegistry().GetEntityIDsWith<Transform, BoxCollider>()) {
-            const auto& tf = GetRegistry().GetComponent<Transform>(entityID);
-            const auto& col = GetRegistry().GetComponent<BoxCollider>(entityID);
+        for (auto [entityID, tf, col] : GetRegistry().View<const Transform, const BoxCollider>()) {
             if(!(tf.enabled && col.enabled)) continue;
 
-            AABB aabbCollider = AABB(tf.GetWorldPosition(), col.size * tf.scale, col.enableRotation ? tf.rotation : glm::quat());
+            AABB aabbCollider = AABB(tf.GetWorldPosition(), col.size * tf.GetScale(), col.enableRotation ? tf.GetRotation() : glm::quat());
 
             auto color = col.collisionsList.size() ? Utils::Colors::RED : col.triggersList.size() ? Utils::Colors::YELLOW : Utils::Colors::GREEN;
             DrawRect(aabbCollider.center, aabbCollider.halfSize * 2.0f, 2.0f, color);
         }
 
-        for (auto entityID : GetRegistry().GetEntityIDsWith<Transform, Rigidbody>()) {
-            const auto& tf = GetRegistry().GetComponent<Transform>(entityID);
-            const auto& rb = GetRegistry().GetComponent<Rigidbody>(entityID);
+        for (auto [entityID, tf, rb] : GetRegistry().View<const Transform, const Rigidbody>()) {
             if(!(tf.enabled && rb.enabled)) continue;
 
             DrawLine(tf.GetWorldPosition(), tf.GetWorldPosition() + (rb.velocity * 50.0f), 1.0f, Utils::Colors::BLUE);
@@ -2,10 +2,6 @@
 #include "../app.hpp"
 #include "../core/logger.hpp"
 
-#include <glm/gtc/matrix_transform.hpp>
-#include <glm/gtc/quaternion.hpp>
-#include <glm/gtx/quaternion.hpp>
-
 using namespace Engine::Graphics;
 using namespace Engine::Scene;
 
@@ -54,15 +50,10 @@ namespace Engine::Render {
         glDeleteVertexArrays(1, &mVAO);
     }
 
-    void SpriteRenderer::DrawSprite(Transform transform, Sprite sprite) {
+    void SpriteRenderer::DrawSprite(const Sprite& sprite, const glm::mat4& model) {
         if(sprite.material.shader) {
             auto mainCamera = GetApp().GetCurrentCamera();
 
-            glm::mat4 model(1.0f);
-            model = glm::translate(model, transform.GetWorldPosition());
-            model *= glm::toMat4(transform.rotation);
-            model = glm::scale(model, glm::vec3(sprite.size, 1.0f) * transform.scale);
-
             sprite.material.Bind();
             sprite.material.shader->SetMat4("u_Projection", mainCamera->GetProjectionMatrix());
             sprite.material.shader->SetMat4("u_View", mainCamera->GetViewMatrix());
@@ -79,20 +70,44 @@ namespace Engine::Render {
     void SpriteRenderer::OnRender(float alpha) {
         auto mainCamera = GetApp().GetCurrentCamera();
 
-        for(EntityID entityID: GetRegistry().GetEntityIDsWith<Transform, Sprite>()) {
-            auto& transform = GetRegistry().GetComponent<Transform>(entityID);
-            auto& sprite = GetRegistry().GetComponent<Sprite>(entityID);
+        Rectangle cameraFrustum = mainCamera->GetFrustum();
+
+        ECS::Registry& registry = GetRegistry();
+
+        mBatch.Clear();
+        mVisibleSprites.clear();
+
+        for(auto [entityID, transform, sprite] : registry.Group<const Transform, const Sprite>()) {
             if(!(transform.enabled && sprite.enabled)) continue;
+
+            // Position, rotation et échelle monde : le cache est à jour depuis la phase PreRender
+            glm::vec3 worldPosition = transform.GetWorldPosition();
+            glm::quat rotation = transform.GetWorldRotation();
+
+            // Les rigidbodies sont affichés entre leur état au pas physique précédent et leur état courant
+            if(registry.HasComponent<Physics::Rigidbody>(entityID)) {
+                const Physics::Rigidbody& rigidbody = registry.GetComponent<Physics::Rigidbody>(entityID);
+                worldPosition = rigidbody.InterpolatePosition(worldPosition, alpha);
+                rotation = rigidbody.InterpolateRotation(rotation, alpha);
+            }
             
             // Si l'entité n'entre pas dans le frustum de la caméra, on la skip
-            Rectangle cameraFrustum = GetApp().GetCurrentCamera()->GetFrustum();
             Rectangle spriteRec = {
-                {transform.GetWorldPosition() - glm::vec3(sprite.size, 0.0f) * 0.5f},
-                {transform.GetWorldPosition() + glm::vec3(sprite.size, 0.0f) * 0.5f}
+                {worldPosition - glm::vec3(sprite.size, 0.0f) * 0.5f},
+                {worldPosition + glm::vec3(sprite.size, 0.0f) * 0.5f}
             };
 
             if((spriteRec.max.x > cameraFrustum.min.x && spriteRec.min.x < cameraFrustum.max.x) && (spriteRec.max.y > cameraFrustum.min.y && spriteRec.min.y < cameraFrustum.max.y))
-                DrawSprite(transform, sprite);
+            {
+                mBatch.Add(worldPosition, rotation, glm::vec3(sprite.size, 1.0f) * transform.GetWorldScale());
+                mVisibleSprites.push_back(&sprite);
+            }
         }
+
+        // Toutes les matrices modèles d'un coup (SIMD), puis les draw calls
+        mModels.resize(mBatch.Size());
+        mBatch.ComputeMatrices(mModels.data());
+
+        for(std::size_t i = 0; i < mVisibleSprites.size(); ++i) DrawSprite(*mVisibleSprites[i], mModels[i]);
     }
 }
\ No newline at end of file
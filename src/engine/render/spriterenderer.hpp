@@ -4,6 +4,8 @@
  */
 #pragma once
 
+#include <vector>
+
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
@@ -11,6 +13,8 @@
 #include "../graphics/material.hpp"
 #include "../graphics/sprite.hpp"
 #include "../scene/transform.hpp"
+#include "../scene/transformbatch.hpp"
+#include "../physics/rigidbody.hpp"
 #include "../ecs/system.hpp"
 
 namespace Engine::Render {
@@ -22,13 +26,18 @@ namespace Engine::Render {
         private:
             GLuint mVAO, mVBO, mEBO;
 
+            /** @brief Transforms des sprites visibles de la frame, dont les matrices sont calculées en un seul lot */
+            Scene::TransformBatch mBatch;
+            std::vector<const Graphics::Sprite*> mVisibleSprites;
+            std::vector<glm::mat4> mModels;
+
             /**
              * @brief Dessine un sprite transformé
              * 
-             * @param transform La composante transforme associée au sprite
              * @param sprite Le sprite à dessiner
+             * @param model La matrice modèle du sprite (position monde, rotation, taille)
              */
-            void DrawSprite(Scene::Transform transform, Graphics::Sprite sprite);
+            void DrawSprite(const Graphics::Sprite& sprite, const glm::mat4& model);
 
         public:
             /**
@@ -49,8 +58,9 @@ namespace Engine::Render {
              * 
              * Pour chaque Entité qui possède en simultané au moins un Transform, et un Sprite,
              * effectue le randu du sprite transformé dans la scène.
+             * Les entités qui ont un Rigidbody sont interpolées entre le pas physique précédent et l'état courant.
              * 
-             * @param alpha Composante utilisée pour mixer les positions du transform et interpoler en cas de baisse de framerate (unused)
+             * @param alpha La fraction de pas fixe écoulée depuis le dernier pas physique (0 => pas précédent, 1 => état courant)
              */
             void OnRender(float alpha = 0.0f) override;
     };
@@ -62,7 +62,7 @@ namespace Engine::Render {
         glDeleteBuffers(1, &mElementVAO);
     }
 
-    void UIRenderer::DrawElement(Element element, Transform transform, glm::mat4 projection) {
+    void UIRenderer::DrawElement(Element element, const Transform& transform, glm::mat4 projection) {
         glm::mat4 model = glm::mat4(1.0f);
         model = glm::translate(model, transform.GetWorldPosition());
         model = glm::scale(model, glm::vec3(element.size, 1.0f) * transform.GetWorldScale());
@@ -77,8 +77,8 @@ namespace Engine::Render {
         glBindVertexArray(0);
     }
 
-    void UIRenderer::PrintText(UI::Text text, Scene::Transform transform, glm::mat4 projection) {
-        glm::vec2 finalTextPosition = GetTransformedPosition(text, transform);
+    void UIRenderer::PrintText(UI::Text text, const Scene::Transform& transform, glm::mat4 projection, glm::vec2 offset) {
+        glm::vec2 finalTextPosition = GetTransformedPosition(text, transform) + offset;
         
         text.shader->Bind();
         text.shader->SetMat4("u_Projection", projection);
@@ -91,9 +91,9 @@ namespace Engine::Render {
 
         if(text.maxWidth) {
             // Démarre avec 3 points en longueur (pour les ... à la fin)
-            float textWidth = 3 * (text.font->GetChar('.').advance >> 6) * transform.scale.x;
+            float textWidth = 3 * (text.font->GetChar('.').advance >> 6) * transform.GetScale().x;
             for(char c : text.text) {
-                float advance = (text.font->GetChar(c).advance >> 6) * transform.scale.x;
+                float advance = (text.font->GetChar(c).advance >> 6) * transform.GetScale().x;
 
                 if (textWidth + advance > text.maxWidth) {
                     visibleText += "...";
@@ -112,11 +112,11 @@ namespace Engine::Render {
         for(char c : visibleText) {
             FontChar ch = text.font->GetChar(c);
 
-            float xpos = x + ch.bearing.x * transform.scale.x;
-            float ypos = (finalTextPosition.y) - (ch.size.y - ch.bearing.y) * transform.scale.y;
+            float xpos = x + ch.bearing.x * transform.GetScale().x;
+            float ypos = (finalTextPosition.y) - (ch.size.y - ch.bearing.y) * transform.GetScale().y;
 
-            float w = ch.size.x * transform.scale.x;
-            float h = ch.size.y * transform.scale.y;
+            float w = ch.size.x * transform.GetScale().x;
+            float h = ch.size.y * transform.GetScale().y;
     
             float vertices[6][4] = {
                 { xpos,     ypos + h,   0.0f, 0.0f },
@@ -134,7 +134,7 @@ namespace Engine::Render {
     
             glDrawArrays(GL_TRIANGLES, 0, 6);
 
-            x += (ch.advance >> 6) * transform.scale.x;
+            x += (ch.advance >> 6) * transform.GetScale().x;
         }
 
         glBindVertexArray(0);
@@ -145,28 +145,21 @@ namespace Engine::Render {
         glm::vec2 mousePos = GetApp().GetMousePosition();
         auto leftMouseBtn = InputManager::GetMouseButton(GLFW_MOUSE_BUTTON_1);
 
-        for(auto entityID : GetRegistry().GetEntityIDsWith<Transform, Element, Action>()) {
-            auto& transform = GetRegistry().GetComponent<Transform>(entityID);
-            auto& element = GetRegistry().GetComponent<Element>(entityID);
-            auto& action = GetRegistry().GetComponent<Action>(entityID);
+        for(auto [entityID, transform, element, action] : GetRegistry().View<const Transform, const Element, Action>()) {
             if(!(transform.enabled && element.enabled && action.enabled)) continue;
 
             bool isInside = IsPointInside(mousePos, transform.GetWorldPosition(), element.size * glm::vec2(transform.GetWorldScale()));
 
             if(isInside && !action.hovered) {
                 action.hovered = true;
-                if(GetRegistry().HasComponent<Behaviour>(entityID)) GetRegistry().GetComponent<Behaviour>(entityID).OnHoverEnter();
+                mPendingEvents.push_back({entityID, ActionEventType::HoverEnter});
             } else if(!isInside && action.hovered) {
                 action.hovered = false;
-                if(GetRegistry().HasComponent<Behaviour>(entityID)) GetRegistry().GetComponent<Behaviour>(entityID).OnHoverExit();
+                mPendingEvents.push_back({entityID, ActionEventType::HoverExit});
             }
 
             if(action.focus != action.prevFocus) {
-                if(GetRegistry().HasComponent<Behaviour>(entityID)) {
-                    if(action.focus) GetRegistry().GetComponent<Behaviour>(entityID).OnFocusEnter();
-                    else GetRegistry().GetComponent<Behaviour>(entityID).OnFocusExit(); 
-                }
-
+                mPendingEvents.push_back({entityID, action.focus ? ActionEventType::FocusEnter : ActionEventType::FocusExit});
                 action.prevFocus = action.focus;
             }
 
@@ -176,9 +169,26 @@ namespace Engine::Render {
 
             if(action.pressed && leftMouseBtn.IsReleased()) {
                 action.pressed = false;
-                if(isInside && GetRegistry().HasComponent<Behaviour>(entityID)) GetRegistry().GetComponent<Behaviour>(entityID).OnSubmit();
+                if(isInside) mPendingEvents.push_back({entityID, ActionEventType::Submit});
+            }
+        }
+
+        // Les callbacks sont appelés une fois le parcours terminé : un script peut créer ou détruire des entités sans
+        // invalider les références utilisées dans la boucle
+        for(const ActionEvent& event : mPendingEvents) {
+            if(!GetRegistry().IsValidEntity(event.entityID) || !GetRegistry().HasComponent<Behaviour>(event.entityID)) continue;
+
+            Behaviour& behaviour = GetRegistry().GetComponent<Behaviour>(event.entityID);
+            switch(event.type) {
+                case ActionEventType::HoverEnter: behaviour.OnHoverEnter(); break;
+                case ActionEventType::HoverExit: behaviour.OnHoverExit(); break;
+                case ActionEventType::FocusEnter: behaviour.OnFocusEnter(); break;
+                case ActionEventType::FocusExit: behaviour.OnFocusExit(); break;
+                case ActionEventType::Submit: behaviour.OnSubmit(); break;
             }
         }
+
+        mPendingEvents.clear();
     }
 
     void UIRenderer::OnUIRender() {
@@ -190,9 +200,7 @@ namespace Engine::Render {
             -1.0f, 1.0f
         );
 
-        for(EntityID entityID: GetRegistry().GetEntityIDsWith<Transform, Element>()) {
-            auto& transform = GetRegistry().GetComponent<Transform>(entityID);
-            auto& element = GetRegistry().GetComponent<Element>(entityID);
+        for(auto [entityID, transform, element] : GetRegistry().View<Transform, Element>()) {
             if(!(transform.enabled && element.enabled)) continue;
 
             // Draw centered around center
@@ -203,35 +211,20 @@ namespace Engine::Render {
             }
         }
 
-        for(EntityID entityID: GetRegistry().GetEntityIDsWith<Transform, Text>()) {
-            auto& transform = GetRegistry().GetComponent<Transform>(entityID);
-            auto& text = GetRegistry().GetComponent<Text>(entityID);
+        for(auto [entityID, transform, text] : GetRegistry().View<Transform, Text>()) {
             if(!(transform.enabled && text.enabled)) continue;
 
             if(text.shader) {
-                // Si l'outline est activée, procède à 4 rendus différents, avec des transforms légèrement altérés
+                // Si l'outline est activée, procède à 4 rendus différents, légèrement décalés
                 if(text.enableOutline) {
-                    Transform tmpTransform = transform;
-                    tmpTransform.position = transform.GetWorldPosition(); // reposition based on world pos before moving around
-
                     Text tmpText = text;
                     tmpText.color = text.outlineColor;
                     float outlineOffset = text.font->GetFontSize() * 0.05f;
 
-                    tmpTransform.position.x -= outlineOffset;
-                    PrintText(tmpText, tmpTransform, uiProjection);
-
-                    tmpTransform = transform;
-                    tmpTransform.position.x += outlineOffset;
-                    PrintText(tmpText, tmpTransform, uiProjection);
-
-                    tmpTransform = transform;
-                    tmpTransform.position.y -= outlineOffset;
-                    PrintText(tmpText, tmpTransform, uiProjection);
-
-                    tmpTransform = transform;
-                    tmpTransform.position.y += outlineOffset;
-                    PrintText(tmpText, tmpTransform, uiProjection);
+                    PrintText(tmpText, transform, uiProjection, {-outlineOffset, 0.0f});
+                    PrintText(tmpText, transform, uiProjection, {outlineOffset, 0.0f});
+                    PrintText(tmpText, transform, uiProjection, {0.0f, -outlineOffset});
+                    PrintText(tmpText, transform, uiProjection, {0.0f, outlineOffset});
                 }
 
                 // Affiche le texte
@@ -242,22 +235,23 @@ namespace Engine::Render {
         }
     }
 
-    glm::vec2 UIRenderer::GetTransformedPosition(Text text, Transform transform) {
-        glm::vec2 computedSize = text.font->GetTextSize(text.text, transform.scale, text.maxWidth);
+    glm::vec2 UIRenderer::GetTransformedPosition(Text text, const Transform& transform) {
+        glm::vec2 computedSize = text.font->GetTextSize(text.text, transform.GetScale(), text.maxWidth);
+        glm::vec3 worldPosition = transform.GetWorldPosition();
 
         switch(text.anchor) {
             case Anchor::BottomLeft:
-                return glm::vec2(transform.GetWorldPosition());
+                return glm::vec2(worldPosition);
 
             case Anchor::Top:
-                return glm::vec2(transform.GetWorldPosition().x - computedSize.x * 0.5f, transform.GetWorldPosition().y - computedSize.y);
+                return glm::vec2(worldPosition.x - computedSize.x * 0.5f, worldPosition.y - computedSize.y);
 
             case Anchor::Bottom:
-                return glm::vec2(transform.GetWorldPosition().x - computedSize.x * 0.5f, transform.GetWorldPosition().y);
+                return glm::vec2(worldPosition.x - computedSize.x * 0.5f, worldPosition.y);
 
             default:
             case Anchor::Center:
-                return (glm::vec2(transform.GetWorldPosition()) - (computedSize * 0.5f));
+                return (glm::vec2(worldPosition) - (computedSize * 0.5f));
         }
     }
 
@@ -19,14 +19,26 @@ namespace Engine::Render {
      */
     class UIRenderer : public ECS::System {
         private:
+            /** @brief Type d'action d'interface à transmettre aux Behaviours */
+            enum class ActionEventType { HoverEnter, HoverExit, FocusEnter, FocusExit, Submit };
+
+            /** @brief Une action d'interface en attente, envoyée aux scripts à la fin de OnUpdate */
+            struct ActionEvent {
+                EntityID entityID;
+                ActionEventType type;
+            };
+
+            /** @brief Actions accumulées pendant le parcours des éléments d'interface */
+            std::vector<ActionEvent> mPendingEvents;
+
             GLuint mTextVAO, mTextVBO;
             GLuint mElementVAO, mElementVBO;
 
-            glm::vec2 GetTransformedPosition(UI::Text text, Scene::Transform transform);
+            glm::vec2 GetTransformedPosition(UI::Text text, const Scene::Transform& transform);
             bool IsPointInside(glm::vec2 point, glm::vec2 targetPosition, glm::vec2 targetSize);
 
-            void PrintText(UI::Text text, Scene::Transform transform, glm::mat4 projection);
-            void DrawElement(UI::Element element, Scene::Transform transform, glm::mat4 projection);
+            void PrintText(UI::Text text, const Scene::Transform& transform, glm::mat4 projection, glm::vec2 offset = glm::vec2(0.0f));
+            void DrawElement(UI::Element element, const Scene::Transform& transform, glm::mat4 projection);
 
         public:
             /**
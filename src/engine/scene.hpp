@@ -4,4 +4,6 @@
 #include "scene/behavioursystem.hpp"
 #include "scene/camera.hpp"
 #include "scene/scene.hpp"
-#include "scene/transform.hpp"
\ No newline at end of file
+#include "scene/transform.hpp"
+#include "scene/transformsystem.hpp"
+#include "scene/transformbatch.hpp"
\ No newline at end of file
@@ -4,63 +4,27 @@
 
 namespace Engine::Scene {
     void BehaviourSystem::OnInit() {
-        for(EntityID entityID: GetRegistry().GetEntityIDsWith<Behaviour>()) {
-            std::vector<Behaviour*> scripts = GetRegistry().GetComponents<Behaviour>(entityID);
-
-            for(auto script : scripts) {
-                if(script->enabled) script->OnInit();
-            }
-        }
+        ForEachScript([](Behaviour* script) { script->OnInit(); });
     }
 
     void BehaviourSystem::OnFixedUpdate(float deltaTime) {
-        for(EntityID entityID: GetRegistry().GetEntityIDsWith<Behaviour>()) {
-            std::vector<Behaviour*> scripts = GetRegistry().GetComponents<Behaviour>(entityID);
-
-            for(auto script : scripts) {
-                if(script->enabled) script->OnFixedUpdate(deltaTime);
-            }
-        }
+        ForEachScript([deltaTime](Behaviour* script) { script->OnFixedUpdate(deltaTime); });
     }
 
     void BehaviourSystem::OnUpdate(float deltaTime) {
-        for(EntityID entityID: GetRegistry().GetEntityIDsWith<Behaviour>()) {
-            std::vector<Behaviour*> scripts = GetRegistry().GetComponents<Behaviour>(entityID);
-
-            for(auto script : scripts) {
-                if(script->enabled) script->OnUpdate(deltaTime);
-            }
-        }
+        ForEachScript([deltaTime](Behaviour* script) { script->OnUpdate(deltaTime); });
     }
     
     void BehaviourSystem::OnRender(float alpha) {
-        for(EntityID entityID: GetRegistry().GetEntityIDsWith<Behaviour>()) {
-            std::vector<Behaviour*> scripts = GetRegistry().GetComponents<Behaviour>(entityID);
-
-            for(auto script : scripts) {
-                if(script->enabled) script->OnRender(alpha);
-            }
-        }
+        ForEachScript([alpha](Behaviour* script) { script->OnRender(alpha); });
     }
 
         
     void BehaviourSystem::OnUIRender() {
-        for(EntityID entityID: GetRegistry().GetEntityIDsWith<Behaviour>()) {
-            std::vector<Behaviour*> scripts = GetRegistry().GetComponents<Behaviour>(entityID);
-
-            for(auto script : scripts) {
-                if(script->enabled) script->OnUIRender();
-            }
-        }
+        ForEachScript([](Behaviour* script) { script->OnUIRender(); });
     }
 
     void BehaviourSystem::OnLateUpdate(float deltaTime) {
-        for(EntityID entityID: GetRegistry().GetEntityIDsWith<Behaviour>()) {
-            std::vector<Behaviour*> scripts = GetRegistry().GetComponents<Behaviour>(entityID);
-
-            for(auto script : scripts) {
-                if(script->enabled) script->OnLateUpdate(deltaTime);
-            }
-        }
+        ForEachScript([deltaTime](Behaviour* script) { script->OnLateUpdate(deltaTime); });
     }
-}
\ No newline at end of file
+}
@@ -4,6 +4,8 @@
  */
 #pragma once
 
+#include <vector>
+
 #include "../ecs/system.hpp"
 
 #include "behaviour.hpp"
@@ -13,6 +15,30 @@ namespace Engine::Scene {
      * @brief Appelle les callbacks de cycle de vie sur les components Behaviour actifs
      */
     class BehaviourSystem : public ECS::System {
+        private:
+            /** @brief Tableau réutilisé d'une frame à l'autre pour copier les scripts de l'entité courante */
+            std::vector<Behaviour*> mScripts;
+
+            /**
+             * @brief Appelle la fonction donnée sur chaque script actif de la scène
+             * 
+             * Les scripts d'une entité sont copiés avant d'être appelés : un script peut donc ajouter ou retirer
+             * des composants Behaviour sans invalider le parcours.
+             * 
+             * @tparam Func Signature attendue : void(Behaviour*)
+             * @param func 
+             */
+            template<typename Func>
+            void ForEachScript(Func&& func) {
+                for(auto [entityID, first] : GetRegistry().View<Behaviour>()) {
+                    GetRegistry().GetComponents<Behaviour>(entityID, mScripts);
+
+                    for(auto script : mScripts) {
+                        if(script->enabled) func(script);
+                    }
+                }
+            }
+
         public:
             void OnInit() override;
             void OnFixedUpdate(float deltaTime) override;
@@ -7,14 +7,18 @@
 #include "../ui/text.hpp"
 
 namespace Engine::Scene {
-    Scene::Scene() {
+    Scene::Scene(ECS::StorageBackend backend, std::size_t entityCapacity) : mRegistry(backend) {
         mRegistry.mScene = this;
+        if(entityCapacity) mRegistry.ReserveEntities(entityCapacity);
     }
 
     ECS::Registry* Scene::GetRegistry() { return &mRegistry; }
     ICamera* Scene::GetCamera() { return mCamera; }
     App& Scene::GetApp() { return *mApp; }
 
+    void Scene::SetBroadPhase(Physics::BroadPhaseType type) { mBroadPhase = type; }
+    Physics::BroadPhaseType Scene::GetBroadPhase() const { return mBroadPhase; }
+
     ECS::Entity Scene::CreateEntity(PrimitiveType type) {
         EntityID id = mRegistry.CreateEntity();
         ECS::Entity entity(id, &mRegistry);
@@ -12,6 +12,7 @@
 
 #include "camera.hpp"
 #include "../core/event.hpp"
+#include "../physics/broadphase.hpp"
 
 // Forward declaration
 namespace Engine { class App; }
@@ -46,13 +47,17 @@ namespace Engine::Scene {
             ECS::Registry mRegistry;
             /** @brief Un event dispatcher spécifique à cette scène */
             Core::EventDispatcher mEventDispatcher;
+            /** @brief Broadphase utilisée par le système physique dans cette scène */
+            Physics::BroadPhaseType mBroadPhase = Physics::BroadPhaseType::SpatialHash;
             
         public:
             /**
              * @brief Construit une nouvelle scène
              * 
+             * @param backend Le mode de stockage des composants du registre de la scène
+             * @param entityCapacity Nombre d'entités attendues dans la scène, réservées à l'avance (0 => aucune réservation)
              */
-            Scene();
+            Scene(ECS::StorageBackend backend = ECS::StorageBackend::SparseSet, std::size_t entityCapacity = 0);
             ~Scene() = default;
 
             /**
@@ -74,6 +79,21 @@ namespace Engine::Scene {
              */
             App& GetApp();
 
+            /**
+             * @brief Choisit la broadphase utilisée par le système physique dans cette scène
+             * 
+             * Le choix est lu par le PhysicSystem au chargement de la scène : à appeler dans le constructeur ou dans OnEnter.
+             * 
+             * @param type 
+             */
+            void SetBroadPhase(Physics::BroadPhaseType type);
+            /**
+             * @brief Renvoie la broadphase utilisée par le système physique dans cette scène
+             * 
+             * @return Physics::BroadPhaseType 
+             */
+            Physics::BroadPhaseType GetBroadPhase() const;
+
             // Event management
             /**
              * @brief Permet d'ajouter un listener aux évènements de la scène
@@ -2,8 +2,55 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace Engine::Scene {
+    namespace {
+        /**
+         * @brief Renvoie le transform du parent d'une entité
+         * 
+         * @param registry 
+         * @param entityID 
+         * @return Transform* nullptr si l'entité n'a pas de parent, ou si son parent n'a pas de Transform
+         */
+        Transform* GetParentTransform(ECS::Registry& registry, EntityID entityID) {
+            EntityID parentID = registry.GetParent(entityID);
+            return parentID != NULL_ENTITY && registry.HasComponent<Transform>(parentID) ? &registry.GetComponent<Transform>(parentID) : nullptr;
+        }
+    }
+
+    void Transform::MarkChanged() {
+        mWorldDirty = true;
+        if(GetEntityID() == NULL_ENTITY) return;
+
+        ECS::Registry& registry = GetRegistry();
+        registry.MarkChanged<Transform>(GetEntityID());
+
+        // Les valeurs monde des descendants dépendent de celles-ci
+        registry.ForEachDescendant(GetEntityID(), [&registry](EntityID descendantID) {
+            if(registry.HasComponent<Transform>(descendantID)) registry.GetComponent<Transform>(descendantID).mWorldDirty = true;
+        });
+    }
+
+    void Transform::SetPosition(const glm::vec3& position) {
+        mPosition = position;
+        MarkChanged();
+    }
+
+    void Transform::SetPosition(const glm::vec2& position) {
+        SetPosition(glm::vec3(position, mPosition.z));
+    }
+
+    void Transform::SetRotation(const glm::quat& rotation) {
+        mRotation = rotation;
+        MarkChanged();
+    }
+
+    void Transform::SetScale(const glm::vec3& scale) {
+        mScale = scale;
+        MarkChanged();
+    }
+
     void Transform::Translate(const glm::vec3& offset) {
-        position += offset;
+        mPosition += offset;
+        MarkChanged();
     }
 
     void Transform::Translate(const glm::vec2& offset) {
@@ -12,8 +59,9 @@ namespace Engine::Scene {
 
     void Transform::Rotate(const glm::vec3& axis, float angleRadians) {
         glm::quat deltaRotation = glm::angleAxis(angleRadians, glm::normalize(axis));
-        rotation = deltaRotation * rotation; // Composition : nouvelle rotation d'abord
-        rotation = glm::normalize(rotation);
+        mRotation = deltaRotation * mRotation; // Composition : nouvelle rotation d'abord
+        mRotation = glm::normalize(mRotation);
+        MarkChanged();
     }
 
     void Transform::Rotate2D(float angleRadians) {
@@ -21,65 +69,75 @@ namespace Engine::Scene {
     }
 
     void Transform::SetRotation2D(float angleRadians) {
-        rotation = glm::normalize(glm::angleAxis(angleRadians, glm::normalize(glm::vec3(0.0f, 0.0f, 1.0f))));
+        mRotation = glm::normalize(glm::angleAxis(angleRadians, glm::normalize(glm::vec3(0.0f, 0.0f, 1.0f))));
+        MarkChanged();
     }
     
     bool Transform::IsRotated() {
         glm::quat id = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-        return id != rotation;
+        return id != mRotation;
+    }
+
+    bool Transform::IsWorldCached() const {
+        return !mWorldDirty && GetEntityID() != NULL_ENTITY && mWorldEntity == GetEntityID() && mWorldVersion == GetRegistry().GetHierarchyVersion();
     }
 
+    // Sans cache valable, on remonte la chaîne des parents jusqu'au premier ancêtre dont le cache est à jour
     glm::vec3 Transform::GetWorldPosition() const {
-        if(GetEntity().HasComponent<ECS::Parent>()) {
-            EntityID parentID = GetEntity().GetComponent<ECS::Parent>().id;
-            if(GetRegistry().IsValidEntity(parentID)) {
-                auto parentT = GetRegistry().GetComponent<Transform>(GetEntity().GetComponent<ECS::Parent>().id);
-                return parentT.GetWorldPosition() + position;
-            }
+        if(IsWorldCached()) return mWorldPosition;
+        if(GetEntityID() == NULL_ENTITY) return mPosition;
+
+        glm::vec3 worldPosition = mPosition;
+        for(const Transform* parent = GetParentTransform(GetRegistry(), GetEntityID()); parent; parent = GetParentTransform(GetRegistry(), parent->GetEntityID())) {
+            if(parent->IsWorldCached()) return parent->mWorldPosition + worldPosition;
+            worldPosition += parent->mPosition;
         }
 
-        return position;
+        return worldPosition;
     }
 
     glm::quat Transform::GetWorldRotation() const {
-        if(GetEntity().HasComponent<ECS::Parent>()) {
-            EntityID parentID = GetEntity().GetComponent<ECS::Parent>().id;
-            if(GetRegistry().IsValidEntity(parentID)) {
-                auto parentT = GetRegistry().GetComponent<Transform>(GetEntity().GetComponent<ECS::Parent>().id);
-                return parentT.GetWorldRotation() * rotation;
-            }
+        if(IsWorldCached()) return mWorldRotation;
+        if(GetEntityID() == NULL_ENTITY) return mRotation;
+
+        glm::quat worldRotation = mRotation;
+        for(const Transform* parent = GetParentTransform(GetRegistry(), GetEntityID()); parent; parent = GetParentTransform(GetRegistry(), parent->GetEntityID())) {
+            if(parent->IsWorldCached()) return parent->mWorldRotation * worldRotation;
+            worldRotation = parent->mRotation * worldRotation;
         }
 
-        return rotation;
+        return worldRotation;
     }
 
     glm::vec3 Transform::GetWorldScale() const {
-        if(GetEntity().HasComponent<ECS::Parent>()) {
-            EntityID parentID = GetEntity().GetComponent<ECS::Parent>().id;
-            if(GetRegistry().IsValidEntity(parentID)) {
-                auto parentT = GetRegistry().GetComponent<Transform>(GetEntity().GetComponent<ECS::Parent>().id);
-                return parentT.GetWorldScale() * scale;
-            }
+        if(IsWorldCached()) return mWorldScale;
+        if(GetEntityID() == NULL_ENTITY) return mScale;
+
+        glm::vec3 worldScale = mScale;
+        for(const Transform* parent = GetParentTransform(GetRegistry(), GetEntityID()); parent; parent = GetParentTransform(GetRegistry(), parent->GetEntityID())) {
+            if(parent->IsWorldCached()) return parent->mWorldScale * worldScale;
+            worldScale *= parent->mScale;
         }
 
-        return scale;
+        return worldScale;
     }
 
     glm::mat4 Transform::GetLocalMatrix() const {
-        return glm::translate(glm::mat4(1.0f), position)
-            * glm::toMat4(rotation)
-            * glm::scale(glm::mat4(1.0f), scale);
+        return glm::translate(glm::mat4(1.0f), mPosition)
+            * glm::toMat4(mRotation)
+            * glm::scale(glm::mat4(1.0f), mScale);
     }
 
     glm::mat4 Transform::GetWorldMatrix() const {
-        if(GetEntity().HasComponent<ECS::Parent>()) {
-            EntityID parentID = GetEntity().GetComponent<ECS::Parent>().id;
-            if(GetRegistry().IsValidEntity(parentID)) {
-                auto parentT = GetRegistry().GetComponent<Transform>(GetEntity().GetComponent<ECS::Parent>().id);
-                return parentT.GetWorldMatrix() * GetLocalMatrix();
-            }
+        if(IsWorldCached()) return mWorldMatrix;
+        if(GetEntityID() == NULL_ENTITY) return GetLocalMatrix();
+
+        glm::mat4 worldMatrix = GetLocalMatrix();
+        for(const Transform* parent = GetParentTransform(GetRegistry(), GetEntityID()); parent; parent = GetParentTransform(GetRegistry(), parent->GetEntityID())) {
+            if(parent->IsWorldCached()) return parent->mWorldMatrix * worldMatrix;
+            worldMatrix = parent->GetLocalMatrix() * worldMatrix;
         }
 
-        return GetLocalMatrix();
+        return worldMatrix;
     }
 }
\ No newline at end of file
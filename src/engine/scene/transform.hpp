@@ -8,23 +8,79 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <ostream>
+#include <cstdint>
 
 #include "../ecs/component.hpp"
 #include "../ecs/hierarchy.hpp"
 
 namespace Engine::Scene {
+    class TransformSystem;
+
     /**
      * @brief Cette structure de donnée permet la gestion d'une entité dans l'espace
      * 
      * ELle donne accès à une position, une rotation et un facteur d'agrandissement permettant le calcul de matrices Model
+     * 
+     * Les valeurs "monde" (position, rotation, scale, matrice) sont mises en cache par le TransformSystem.
+     * Tant que le cache est valable, les getters monde le lisent directement, sinon ils remontent la chaîne des parents.
+     * 
+     * Les valeurs locales ne sont modifiables que par les setters (SetPosition, Translate, Rotate...), qui signalent le changement :
+     * le cache ne peut donc pas rester valable après une modification.
      */
     struct Transform : public ECS::Component {
-        /** @brief La position dans la scène */
-        glm::vec3 position              = {0.0f, 0.0f, 0.0f};
-        /** @brief La rotation (quaternion) du transform */
-        glm::quat rotation              = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-        /** @brief Facteur d'argrandissement par lequel tous les components avec une taille sont mis à l'échelle */
-        glm::vec3 scale     = {1.0f, 1.0f, 1.0f};
+        friend class TransformSystem;
+
+        /**
+         * @brief Signale au registre que le transform a été modifié (voir Registry::MarkChanged)
+         * 
+         * Tous les setters le font d'eux-mêmes : les systèmes réactifs (physique...) voient le changement,
+         * et les valeurs monde en cache du transform et de ses descendants sont invalidées.
+         */
+        void MarkChanged();
+
+        /**
+         * @brief Renvoie la position locale (relative au parent s'il y en a un)
+         * 
+         * @return const glm::vec3& 
+         */
+        const glm::vec3& GetPosition() const { return mPosition; }
+        /**
+         * @brief Renvoie la rotation locale (quaternion)
+         * 
+         * @return const glm::quat& 
+         */
+        const glm::quat& GetRotation() const { return mRotation; }
+        /**
+         * @brief Renvoie le facteur d'agrandissement local
+         * 
+         * @return const glm::vec3& 
+         */
+        const glm::vec3& GetScale() const { return mScale; }
+
+        /**
+         * @brief Règle la position locale
+         * 
+         * @param position 
+         */
+        void SetPosition(const glm::vec3& position);
+        /**
+         * @brief Règle la position locale sur X et Y (Z est gardé)
+         * 
+         * @param position 
+         */
+        void SetPosition(const glm::vec2& position);
+        /**
+         * @brief Règle la rotation locale
+         * 
+         * @param rotation 
+         */
+        void SetRotation(const glm::quat& rotation);
+        /**
+         * @brief Règle le facteur d'agrandissement local
+         * 
+         * @param scale 
+         */
+        void SetScale(const glm::vec3& scale);
 
         /**
          * @brief Déplace le component d'un offset donné
@@ -68,6 +124,14 @@ namespace Engine::Scene {
          */
         bool IsRotated();
 
+        /**
+         * @brief Vérifie si les valeurs monde en cache sont à jour (les getters monde sont alors en O(1))
+         * 
+         * @return true 
+         * @return false 
+         */
+        bool IsWorldCached() const;
+
         /**
          * @brief Renvoie la position du transform dans le "monde"
          * 
@@ -102,5 +166,25 @@ namespace Engine::Scene {
          * @return glm::mat4 
          */
         glm::mat4 GetWorldMatrix() const;
+
+        private:
+            /** @brief La position dans la scène */
+            glm::vec3 mPosition = {0.0f, 0.0f, 0.0f};
+            /** @brief La rotation (quaternion) du transform */
+            glm::quat mRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+            /** @brief Facteur d'argrandissement par lequel tous les components avec une taille sont mis à l'échelle */
+            glm::vec3 mScale = {1.0f, 1.0f, 1.0f};
+
+            /** @brief Cache des valeurs monde, calculé par le TransformSystem */
+            glm::mat4 mWorldMatrix = glm::mat4(1.0f);
+            glm::vec3 mWorldPosition = {0.0f, 0.0f, 0.0f};
+            glm::quat mWorldRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+            glm::vec3 mWorldScale = {1.0f, 1.0f, 1.0f};
+            /** @brief L'entité pour laquelle le cache a été calculé (un transform copié sur une autre entité n'est pas valable) */
+            EntityID mWorldEntity = NULL_ENTITY;
+            /** @brief Version de la hiérarchie au moment du calcul (voir Registry::GetHierarchyVersion) */
+            std::uint32_t mWorldVersion = 0;
+            /** @brief Vrai si le transform ou l'un de ses ancêtres a changé depuis le calcul (voir MarkChanged) */
+            bool mWorldDirty = true;
     };
 }
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "transformbatch.hpp"
+
+#include <atomic>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define ENGINE_SIMD_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#endif
+
+// GCC et Clang ne compilent une fonction en SSE/AVX que sur demande, MSVC accepte les intrinsèques partout
+#if defined(ENGINE_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define ENGINE_TARGET_SSE __attribute__((target("sse")))
+    #define ENGINE_TARGET_AVX __attribute__((target("avx")))
+#else
+    #define ENGINE_TARGET_SSE
+    #define ENGINE_TARGET_AVX
+#endif
+
+namespace Engine::Scene {
+    namespace {
+        static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "TransformBatch: glm::mat4 must be tightly packed");
+        static_assert(sizeof(glm::mat3x2) == 6 * sizeof(float), "TransformBatch: glm::mat3x2 must be tightly packed");
+
+        /** @brief Les tableaux d'un lot, lus par les noyaux de calcul */
+        struct Arrays {
+            const float* px; const float* py; const float* pz;
+            const float* qx; const float* qy; const float* qz; const float* qw;
+            const float* sx; const float* sy; const float* sz;
+        };
+
+        void MatricesScalar(const Arrays& in, std::size_t begin, std::size_t end, float* out) {
+            for(std::size_t i = begin; i < end; ++i, out += 16) {
+                float x2 = in.qx[i] + in.qx[i], y2 = in.qy[i] + in.qy[i], z2 = in.qz[i] + in.qz[i];
+                float xx = in.qx[i] * x2, yy = in.qy[i] * y2, zz = in.qz[i] * z2;
+                float xy = in.qx[i] * y2, xz = in.qx[i] * z2, yz = in.qy[i] * z2;
+                float wx = in.qw[i] * x2, wy = in.qw[i] * y2, wz = in.qw[i] * z2;
+
+                out[0] = (1.0f - (yy + zz)) * in.sx[i]; out[1] = (xy + wz) * in.sx[i]; out[2] = (xz - wy) * in.sx[i]; out[3] = 0.0f;
+                out[4] = (xy - wz) * in.sy[i]; out[5] = (1.0f - (xx + zz)) * in.sy[i]; out[6] = (yz + wx) * in.sy[i]; out[7] = 0.0f;
+                out[8] = (xz + wy) * in.sz[i]; out[9] = (yz - wx) * in.sz[i]; out[10] = (1.0f - (xx + yy)) * in.sz[i]; out[11] = 0.0f;
+                out[12] = in.px[i]; out[13] = in.py[i]; out[14] = in.pz[i]; out[15] = 1.0f;
+            }
+        }
+
+        void Affine2DScalar(const Arrays& in, std::size_t begin, std::size_t end, float* out) {
+            for(std::size_t i = begin; i < end; ++i, out += 6) {
+                float x2 = in.qx[i] + in.qx[i], y2 = in.qy[i] + in.qy[i], z2 = in.qz[i] + in.qz[i];
+                float xx = in.qx[i] * x2, yy = in.qy[i] * y2, zz = in.qz[i] * z2;
+                float xy = in.qx[i] * y2, wz = in.qw[i] * z2;
+
+                out[0] = (1.0f - (yy + zz)) * in.sx[i]; out[1] = (xy + wz) * in.sx[i];
+                out[2] = (xy - wz) * in.sy[i]; out[3] = (1.0f - (xx + zz)) * in.sy[i];
+                out[4] = in.px[i]; out[5] = in.py[i];
+            }
+        }
+
+#if defined(ENGINE_SIMD_X86)
+        /**
+         * @brief Transpose 4 vecteurs (élément e pour 4 transforms) et écrit la colonne column des 4 matrices
+         * 
+         */
+        ENGINE_TARGET_SSE inline void StoreColumnSSE(float* out, std::size_t column, __m128 a, __m128 b, __m128 c, __m128 d) {
+            _MM_TRANSPOSE4_PS(a, b, c, d);
+            _mm_storeu_ps(out + column * 4, a);
+            _mm_storeu_ps(out + 16 + column * 4, b);
+            _mm_storeu_ps(out + 32 + column * 4, c);
+            _mm_storeu_ps(out + 48 + column * 4, d);
+        }
+
+        ENGINE_TARGET_SSE void MatricesSSE(const Arrays& in, std::size_t begin, std::size_t end, float* out) {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 zero = _mm_setzero_ps();
+
+            std::size_t i = begin;
+            for(; i + 4 <= end; i += 4, out += 64) {
+                __m128 x = _mm_loadu_ps(in.qx + i), y = _mm_loadu_ps(in.qy + i), z = _mm_loadu_ps(in.qz + i), w = _mm_loadu_ps(in.qw + i);
+                __m128 sx = _mm_loadu_ps(in.sx + i), sy = _mm_loadu_ps(in.sy + i), sz = _mm_loadu_ps(in.sz + i);
+
+                __m128 x2 = _mm_add_ps(x, x), y2 = _mm_add_ps(y, y), z2 = _mm_add_ps(z, z);
+                __m128 xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+                __m128 xy = _mm_mul_ps(x, y2), xz = _mm_mul_ps(x, z2), yz = _mm_mul_ps(y, z2);
+                __m128 wx = _mm_mul_ps(w, x2), wy = _mm_mul_ps(w, y2), wz = _mm_mul_ps(w, z2);
+
+                StoreColumnSSE(out, 0, _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx), _mm_mul_ps(_mm_add_ps(xy, wz), sx), _mm_mul_ps(_mm_sub_ps(xz, wy), sx), zero);
+                StoreColumnSSE(out, 1, _mm_mul_ps(_mm_sub_ps(xy, wz), sy), _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy), _mm_mul_ps(_mm_add_ps(yz, wx), sy), zero);
+                StoreColumnSSE(out, 2, _mm_mul_ps(_mm_add_ps(xz, wy), sz), _mm_mul_ps(_mm_sub_ps(yz, wx), sz), _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz), zero);
+                StoreColumnSSE(out, 3, _mm_loadu_ps(in.px + i), _mm_loadu_ps(in.py + i), _mm_loadu_ps(in.pz + i), one);
+            }
+
+            MatricesScalar(in, i, end, out);
+        }
+
+        ENGINE_TARGET_SSE void Affine2DSSE(const Arrays& in, std::size_t begin, std::size_t end, float* out) {
+            const __m128 one = _mm_set1_ps(1.0f);
+
+            std::size_t i = begin;
+            for(; i + 4 <= end; i += 4, out += 24) {
+                __m128 x = _mm_loadu_ps(in.qx + i), y = _mm_loadu_ps(in.qy + i), z = _mm_loadu_ps(in.qz + i), w = _mm_loadu_ps(in.qw + i);
+                __m128 sx = _mm_loadu_ps(in.sx + i), sy = _mm_loadu_ps(in.sy + i);
+
+                __m128 x2 = _mm_add_ps(x, x), y2 = _mm_add_ps(y, y), z2 = _mm_add_ps(z, z);
+                __m128 xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+                __m128 xy = _mm_mul_ps(x, y2), wz = _mm_mul_ps(w, z2);
+
+                __m128 a = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx);
+                __m128 b = _mm_mul_ps(_mm_add_ps(xy, wz), sx);
+                __m128 c = _mm_mul_ps(_mm_sub_ps(xy, wz), sy);
+                __m128 d = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy);
+                _MM_TRANSPOSE4_PS(a, b, c, d);
+
+                __m128 tx = _mm_loadu_ps(in.px + i), ty = _mm_loadu_ps(in.py + i);
+                __m128 t01 = _mm_unpacklo_ps(tx, ty), t23 = _mm_unpackhi_ps(tx, ty);
+
+                _mm_storeu_ps(out, a);      _mm_storel_pi(reinterpret_cast<__m64*>(out + 4), t01);
+                _mm_storeu_ps(out + 6, b);  _mm_storeh_pi(reinterpret_cast<__m64*>(out + 10), t01);
+                _mm_storeu_ps(out + 12, c); _mm_storel_pi(reinterpret_cast<__m64*>(out + 16), t23);
+                _mm_storeu_ps(out + 18, d); _mm_storeh_pi(reinterpret_cast<__m64*>(out + 22), t23);
+            }
+
+            Affine2DScalar(in, i, end, out);
+        }
+
+        /**
+         * @brief Transpose 4 vecteurs (élément e pour 8 transforms) et écrit la colonne column des 8 matrices
+         * 
+         * La transposition se fait dans chaque moitié de 128 bits : la moitié basse donne les transforms 0 à 3, la haute 4 à 7.
+         */
+        ENGINE_TARGET_AVX inline void StoreColumnAVX(float* out, std::size_t column, __m256 a, __m256 b, __m256 c, __m256 d) {
+            __m256 t0 = _mm256_unpacklo_ps(a, b), t1 = _mm256_unpacklo_ps(c, d);
+            __m256 t2 = _mm256_unpackhi_ps(a, b), t3 = _mm256_unpackhi_ps(c, d);
+            __m256 rows[4] = {
+                _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0)),
+                _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2)),
+                _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0)),
+                _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2))
+            };
+
+            for(std::size_t k = 0; k < 4; ++k) {
+                _mm_storeu_ps(out + k * 16 + column * 4, _mm256_castps256_ps128(rows[k]));
+                _mm_storeu_ps(out + (k + 4) * 16 + column * 4, _mm256_extractf128_ps(rows[k], 1));
+            }
+        }
+
+        ENGINE_TARGET_AVX void MatricesAVX(const Arrays& in, std::size_t begin, std::size_t end, float* out) {
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 zero = _mm256_setzero_ps();
+
+            std::size_t i = begin;
+            for(; i + 8 <= end; i += 8, out += 128) {
+                __m256 x = _mm256_loadu_ps(in.qx + i), y = _mm256_loadu_ps(in.qy + i), z = _mm256_loadu_ps(in.qz + i), w = _mm256_loadu_ps(in.qw + i);
+                __m256 sx = _mm256_loadu_ps(in.sx + i), sy = _mm256_loadu_ps(in.sy + i), sz = _mm256_loadu_ps(in.sz + i);
+
+                __m256 x2 = _mm256_add_ps(x, x), y2 = _mm256_add_ps(y, y), z2 = _mm256_add_ps(z, z);
+                __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+                __m256 xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+                __m256 wx = _mm256_mul_ps(w, x2), wy = _mm256_mul_ps(w, y2), wz = _mm256_mul_ps(w, z2);
+
+                StoreColumnAVX(out, 0, _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx), _mm256_mul_ps(_mm256_add_ps(xy, wz), sx), _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx), zero);
+                StoreColumnAVX(out, 1, _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy), _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy), _mm256_mul_ps(_mm256_add_ps(yz, wx), sy), zero);
+                StoreColumnAVX(out, 2, _mm256_mul_ps(_mm256_add_ps(xz, wy), sz), _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz), _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz), zero);
+                StoreColumnAVX(out, 3, _mm256_loadu_ps(in.px + i), _mm256_loadu_ps(in.py + i), _mm256_loadu_ps(in.pz + i), one);
+            }
+
+            MatricesScalar(in, i, end, out);
+        }
+
+        ENGINE_TARGET_AVX void Affine2DAVX(const Arrays& in, std::size_t begin, std::size_t end, float* out) {
+            const __m256 one = _mm256_set1_ps(1.0f);
+
+            std::size_t i = begin;
+            for(; i + 8 <= end; i += 8, out += 48) {
+                __m256 x = _mm256_loadu_ps(in.qx + i), y = _mm256_loadu_ps(in.qy + i), z = _mm256_loadu_ps(in.qz + i), w = _mm256_loadu_ps(in.qw + i);
+                __m256 sx = _mm256_loadu_ps(in.sx + i), sy = _mm256_loadu_ps(in.sy + i);
+
+                __m256 x2 = _mm256_add_ps(x, x), y2 = _mm256_add_ps(y, y), z2 = _mm256_add_ps(z, z);
+                __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+                __m256 xy = _mm256_mul_ps(x, y2), wz = _mm256_mul_ps(w, z2);
+
+                __m256 a = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx);
+                __m256 b = _mm256_mul_ps(_mm256_add_ps(xy, wz), sx);
+                __m256 c = _mm256_mul_ps(_mm256_sub_ps(xy, wz), sy);
+                __m256 d = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy);
+
+                // Même transposition que StoreColumnAVX : rows[k] contient le transform k (moitié basse) et k + 4 (moitié haute)
+                __m256 t0 = _mm256_unpacklo_ps(a, b), t1 = _mm256_unpacklo_ps(c, d);
+                __m256 t2 = _mm256_unpackhi_ps(a, b), t3 = _mm256_unpackhi_ps(c, d);
+                __m256 rows[4] = {
+                    _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0)),
+                    _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2)),
+                    _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0)),
+                    _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2))
+                };
+
+                // Translations : tx/ty entrelacés, deux transforms par demi-registre
+                __m256 tx = _mm256_loadu_ps(in.px + i), ty = _mm256_loadu_ps(in.py + i);
+                __m256 tlo = _mm256_unpacklo_ps(tx, ty), thi = _mm256_unpackhi_ps(tx, ty);
+                __m128 translations[4] = {
+                    _mm256_castps256_ps128(tlo), _mm256_castps256_ps128(thi),
+                    _mm256_extractf128_ps(tlo, 1), _mm256_extractf128_ps(thi, 1)
+                };
+
+                for(std::size_t k = 0; k < 4; ++k) {
+                    float* low = out + k * 6;
+                    float* high = out + (k + 4) * 6;
+                    _mm_storeu_ps(low, _mm256_castps256_ps128(rows[k]));
+                    _mm_storeu_ps(high, _mm256_extractf128_ps(rows[k], 1));
+                }
+                for(std::size_t pair = 0; pair < 4; ++pair) {
+                    _mm_storel_pi(reinterpret_cast<__m64*>(out + (pair * 2) * 6 + 4), translations[pair]);
+                    _mm_storeh_pi(reinterpret_cast<__m64*>(out + (pair * 2 + 1) * 6 + 4), translations[pair]);
+                }
+            }
+
+            Affine2DScalar(in, i, end, out);
+        }
+#endif
+
+        SimdLevel DetectSimdLevel() {
+#if defined(ENGINE_SIMD_X86)
+    #if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 1);
+            bool sse = (info[3] >> 25) & 1;
+            bool avx = ((info[2] >> 28) & 1) && ((info[2] >> 27) & 1); // AVX + OSXSAVE
+            // Le système doit aussi sauvegarder les registres AVX (XCR0 : état SSE et AVX)
+            if(avx && (_xgetbv(0) & 0x6) == 0x6) return SimdLevel::AVX;
+            if(sse) return SimdLevel::SSE;
+    #else
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx")) return SimdLevel::AVX;
+            if(__builtin_cpu_supports("sse")) return SimdLevel::SSE;
+    #endif
+#endif
+            return SimdLevel::Scalar;
+        }
+
+        std::atomic<SimdLevel>& CurrentLevel() {
+            static std::atomic<SimdLevel> level = TransformBatch::GetSupportedSimdLevel();
+            return level;
+        }
+    }
+
+    void TransformBatch::Clear() {
+        for(auto* array : {&mPositionX, &mPositionY, &mPositionZ, &mRotationX, &mRotationY, &mRotationZ, &mRotationW, &mScaleX, &mScaleY, &mScaleZ}) {
+            array->clear();
+        }
+    }
+
+    void TransformBatch::Reserve(std::size_t count) {
+        for(auto* array : {&mPositionX, &mPositionY, &mPositionZ, &mRotationX, &mRotationY, &mRotationZ, &mRotationW, &mScaleX, &mScaleY, &mScaleZ}) {
+            array->reserve(count);
+        }
+    }
+
+    void TransformBatch::Add(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+        mPositionX.push_back(position.x); mPositionY.push_back(position.y); mPositionZ.push_back(position.z);
+        mRotationX.push_back(rotation.x); mRotationY.push_back(rotation.y); mRotationZ.push_back(rotation.z); mRotationW.push_back(rotation.w);
+        mScaleX.push_back(scale.x); mScaleY.push_back(scale.y); mScaleZ.push_back(scale.z);
+    }
+
+    void TransformBatch::ComputeMatrices(std::size_t begin, std::size_t end, glm::mat4* out) const {
+        end = std::min(end, Size());
+        if(begin >= end) return;
+
+        Arrays in{mPositionX.data(), mPositionY.data(), mPositionZ.data(), mRotationX.data(), mRotationY.data(), mRotationZ.data(), mRotationW.data(), mScaleX.data(), mScaleY.data(), mScaleZ.data()};
+        float* floats = &out[0][0][0];
+
+        switch(GetSimdLevel()) {
+#if defined(ENGINE_SIMD_X86)
+            case SimdLevel::AVX: MatricesAVX(in, begin, end, floats); break;
+            case SimdLevel::SSE: MatricesSSE(in, begin, end, floats); break;
+#endif
+            default: MatricesScalar(in, begin, end, floats); break;
+        }
+    }
+
+    void TransformBatch::ComputeAffine2D(std::size_t begin, std::size_t end, glm::mat3x2* out) const {
+        end = std::min(end, Size());
+        if(begin >= end) return;
+
+        Arrays in{mPositionX.data(), mPositionY.data(), mPositionZ.data(), mRotationX.data(), mRotationY.data(), mRotationZ.data(), mRotationW.data(), mScaleX.data(), mScaleY.data(), mScaleZ.data()};
+        float* floats = &out[0][0][0];
+
+        switch(GetSimdLevel()) {
+#if defined(ENGINE_SIMD_X86)
+            case SimdLevel::AVX: Affine2DAVX(in, begin, end, floats); break;
+            case SimdLevel::SSE: Affine2DSSE(in, begin, end, floats); break;
+#endif
+            default: Affine2DScalar(in, begin, end, floats); break;
+        }
+    }
+
+    SimdLevel TransformBatch::GetSupportedSimdLevel() {
+        static const SimdLevel supported = DetectSimdLevel();
+        return supported;
+    }
+
+    SimdLevel TransformBatch::GetSimdLevel() {
+        return CurrentLevel().load(std::memory_order_relaxed);
+    }
+
+    void TransformBatch::SetSimdLevel(SimdLevel level) {
+        CurrentLevel().store(std::min(level, GetSupportedSimdLevel()), std::memory_order_relaxed);
+    }
+}
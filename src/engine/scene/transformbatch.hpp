@@ -0,0 +1,120 @@
+/**
+ * @file transformbatch.hpp
+ * @brief Calcul par lots des matrices de transformation, à partir de tableaux séparés (SoA) position/rotation/scale
+ * 
+ * Les transforms sont rangés composante par composante (tous les x, puis tous les y...) : les instructions SIMD
+ * traitent ainsi 4 (SSE) ou 8 (AVX) transforms à la fois. Le jeu d'instructions est choisi à l'exécution selon le
+ * processeur, avec une version scalaire pour les processeurs (ou architectures) qui n'en ont pas.
+ * 
+ * Utilisation :
+ *   batch.Clear();
+ *   for(...) batch.Add(position, rotation, scale);
+ *   matrices.resize(batch.Size());
+ *   batch.ComputeMatrices(matrices.data());
+ */
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Engine::Scene {
+    /**
+     * @brief Les jeux d'instructions utilisables par les calculs par lots, du moins au plus rapide
+     * 
+     */
+    enum class SimdLevel {
+        Scalar,
+        SSE,
+        AVX
+    };
+
+    /**
+     * @brief Lot de transforms rangés en SoA, et calcul de leurs matrices
+     * 
+     * Chaque matrice vaut translate(position) * toMat4(rotation) * scale(scale), comme Transform::GetLocalMatrix.
+     */
+    class TransformBatch {
+        private:
+            std::vector<float> mPositionX, mPositionY, mPositionZ;
+            std::vector<float> mRotationX, mRotationY, mRotationZ, mRotationW;
+            std::vector<float> mScaleX, mScaleY, mScaleZ;
+
+        public:
+            /**
+             * @brief Vide le lot (la mémoire est gardée pour le lot suivant)
+             * 
+             */
+            void Clear();
+
+            /**
+             * @brief Réserve la place pour count transforms
+             * 
+             * @param count
+             */
+            void Reserve(std::size_t count);
+
+            /**
+             * @brief Ajoute un transform à la fin du lot
+             * 
+             * @param position
+             * @param rotation Un quaternion unitaire
+             * @param scale
+             */
+            void Add(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+            /**
+             * @brief Renvoie le nombre de transforms du lot
+             * 
+             * @return std::size_t
+             */
+            std::size_t Size() const { return mPositionX.size(); }
+
+            /**
+             * @brief Calcule les matrices 4x4 des transforms [begin, end[
+             * 
+             * Des intervalles disjoints peuvent être calculés en même temps sur plusieurs threads (voir JobSystem::ParallelFor).
+             * 
+             * @param begin
+             * @param end
+             * @param out Reçoit la matrice du transform i en out[i - begin]
+             */
+            void ComputeMatrices(std::size_t begin, std::size_t end, glm::mat4* out) const;
+            void ComputeMatrices(glm::mat4* out) const { ComputeMatrices(0, Size(), out); }
+
+            /**
+             * @brief Calcule les transformations affines 2D (plan XY) des transforms [begin, end[
+             * 
+             * Chaque matrice contient les deux premières colonnes de la rotation mise à l'échelle, puis la translation en x et y.
+             * 
+             * @param begin
+             * @param end
+             * @param out Reçoit la transformation du transform i en out[i - begin]
+             */
+            void ComputeAffine2D(std::size_t begin, std::size_t end, glm::mat3x2* out) const;
+            void ComputeAffine2D(glm::mat3x2* out) const { ComputeAffine2D(0, Size(), out); }
+
+            /**
+             * @brief Renvoie le meilleur jeu d'instructions supporté par le processeur
+             * 
+             * @return SimdLevel
+             */
+            static SimdLevel GetSupportedSimdLevel();
+
+            /**
+             * @brief Renvoie le jeu d'instructions utilisé par les calculs
+             * 
+             * @return SimdLevel
+             */
+            static SimdLevel GetSimdLevel();
+
+            /**
+             * @brief Change le jeu d'instructions utilisé par les calculs (comparaisons de performances, débogage)
+             * 
+             * @param level Ramené au meilleur niveau supporté s'il n'est pas disponible
+             */
+            static void SetSimdLevel(SimdLevel level);
+    };
+}
@@ -0,0 +1,73 @@
+#include "transformsystem.hpp"
+
+namespace Engine::Scene {
+    void TransformSystem::OnInit() {
+        mTick = 0;
+        mHierarchyVersion = 0;
+    }
+
+    void TransformSystem::OnPreRender(float deltaTime) {
+        Propagate();
+    }
+
+    void TransformSystem::UpdateWorld(Transform& transform, const Transform* parent) {
+        glm::mat4 localMatrix = transform.GetLocalMatrix();
+
+        if(parent) {
+            transform.mWorldPosition = parent->mWorldPosition + transform.mPosition;
+            transform.mWorldRotation = parent->mWorldRotation * transform.mRotation;
+            transform.mWorldScale = parent->mWorldScale * transform.mScale;
+            transform.mWorldMatrix = parent->mWorldMatrix * localMatrix;
+        } else {
+            transform.mWorldPosition = transform.mPosition;
+            transform.mWorldRotation = transform.mRotation;
+            transform.mWorldScale = transform.mScale;
+            transform.mWorldMatrix = localMatrix;
+        }
+
+        transform.mWorldEntity = transform.GetEntityID();
+        transform.mWorldVersion = GetRegistry().GetHierarchyVersion();
+        transform.mWorldDirty = false;
+    }
+
+    void TransformSystem::Propagate() {
+        ECS::Registry& registry = GetRegistry();
+
+        ChangeTick since = mTick;
+        mTick = registry.AdvanceChangeTick();
+
+        // Un lien a changé : tous les caches sont périmés, on repart des racines
+        bool relinked = registry.GetHierarchyVersion() != mHierarchyVersion;
+        mHierarchyVersion = registry.GetHierarchyVersion();
+
+        auto updateRoot = [this, &registry](EntityID entityID, Transform& transform) {
+            EntityID parentID = registry.GetParent(entityID);
+            if(parentID == NULL_ENTITY || !registry.HasComponent<Transform>(parentID)) UpdateWorld(transform, nullptr);
+        };
+
+        if(relinked) {
+            for(auto [entityID, transform] : registry.View<Transform>()) {
+                transform.mWorldDirty = true;
+                updateRoot(entityID, transform);
+            }
+        } else {
+            // Les racines modifiées : les autres racines ont un cache à jour
+            registry.ForEachChanged<Transform>(since, [&](EntityID entityID) {
+                Transform& transform = registry.GetComponent<Transform>(entityID);
+                if(transform.mWorldDirty) updateRoot(entityID, transform);
+            });
+        }
+
+        // Puis la hiérarchie, triée par profondeur : le parent est toujours à jour quand on arrive à l'enfant
+        for(EntityID entityID : registry.GetHierarchyOrder()) {
+            if(!registry.HasComponent<Transform>(entityID)) continue;
+
+            Transform& transform = registry.GetComponent<Transform>(entityID);
+            if(!transform.mWorldDirty) continue;
+
+            EntityID parentID = registry.GetParent(entityID);
+            bool hasParentTransform = parentID != NULL_ENTITY && registry.HasComponent<Transform>(parentID);
+            UpdateWorld(transform, hasParentTransform ? &registry.GetComponent<Transform>(parentID) : nullptr);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * @file transformsystem.hpp
+ * @brief Calcule les valeurs monde des Transforms une fois par frame, des parents vers les enfants
+ */
+#pragma once
+
+#include <cstdint>
+
+#include "../ecs/system.hpp"
+
+#include "transform.hpp"
+
+namespace Engine::Scene {
+    /**
+     * @brief Met à jour le cache des valeurs monde (matrice, position, rotation, scale) des Transforms
+     * 
+     * Seuls les transforms marqués comme modifiés (voir Transform::MarkChanged), et leurs descendants, sont recalculés.
+     * Après un changement de lien dans la hiérarchie, tous les transforms sont recalculés une fois.
+     * Le calcul a lieu dans la phase PreRender, après le FixedUpdate, l'Update et leurs points de synchronisation :
+     * les renderers lisent donc un cache à jour pour toutes les entités déplacées dans la frame. Un système qui déplace
+     * des entités dans la phase PreRender doit être enregistré avant celui-ci.
+     */
+    class TransformSystem : public ECS::System {
+        private:
+            /** @brief Valeur du compteur de changements lors du dernier calcul */
+            ChangeTick mTick = 0;
+            /** @brief Version de la hiérarchie lors du dernier calcul (0 => tout recalculer) */
+            std::uint32_t mHierarchyVersion = 0;
+
+            /**
+             * @brief Calcule les valeurs monde d'un transform à partir de celles de son parent
+             * 
+             * @param transform 
+             * @param parent Le transform du parent, à jour (nullptr pour une racine)
+             */
+            void UpdateWorld(Transform& transform, const Transform* parent);
+
+        public:
+            TransformSystem() { Writes<Transform>(); Reads<ECS::Parent, ECS::Children>(); }
+
+            /**
+             * @brief Appelé au chargement d'une scène : tous les transforms du nouveau registre seront recalculés
+             * 
+             */
+            void OnInit() override;
+            void OnPreRender(float deltaTime) override;
+
+            /**
+             * @brief Recalcule les valeurs monde des transforms modifiés et de leurs descendants
+             * 
+             * Appelée par OnPreRender, elle peut aussi l'être à la main pour rafraîchir le cache au milieu d'une frame.
+             */
+            void Propagate();
+    };
+}
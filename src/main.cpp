@@ -32,6 +32,7 @@ class Game : public Engine::App {
             RegisterSystem<SpriteAnimationSystem>();
             RegisterSystem<UIRenderer>();
             RegisterSystem<ParticleSystem>();
+            RegisterSystem<TransformSystem>(); // Caches world transforms in the PreRender phase, after FixedUpdate and Update moved entities
             
              // Define defaults variables
             ResourceManager::LoadPak("data/default.pak", "default");
@@ -56,6 +57,7 @@ int _main() {
     settings.windowWidth = engineConf.GetInt("WINDOW", "width", 800);
     settings.windowHeight = engineConf.GetInt("WINDOW", "height", 600);
     settings.clearColor = RGBAColor(92, 102, 86);
+    settings.fixedStepFramerate = engineConf.GetFloat("PHYSICS", "fixedStepFramerate", FIXED_STEP_FRAMERATE);
 
     Game ogl_engine(1920, 1080, settings);
     ogl_engine.Run();
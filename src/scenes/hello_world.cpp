@@ -18,24 +18,24 @@ void HelloWorld::OnEnter() {
     auto text = CreateEntity(PrimitiveType::Text);
     text.GetComponent<UI::Text>().anchor = Anchor::Top;
     text.GetComponent<UI::Text>().text = "Hello there !";
-    text.GetComponent<Transform>().position.y = GetApp().GetHeight() * 0.45f;
+    text.GetComponent<Transform>().SetPosition(glm::vec2(0.0f, GetApp().GetHeight() * 0.45f));
 
     // Create the walls
     auto wallTop = CreateEntity(PrimitiveType::Quad);
-    wallTop.GetComponent<Transform>().position.y = GetApp().GetHeight() * 0.5f;
-    wallTop.GetComponent<Transform>().scale = glm::vec3(GetApp().GetWidth(), 50.0f, 0.0f);
+    wallTop.GetComponent<Transform>().SetPosition(glm::vec2(0.0f, GetApp().GetHeight() * 0.5f));
+    wallTop.GetComponent<Transform>().SetScale(glm::vec3(GetApp().GetWidth(), 50.0f, 0.0f));
     wallTop.GetComponent<Rigidbody>().isKinematic = true;
     auto wallBot = CreateEntity(PrimitiveType::Quad);
-    wallBot.GetComponent<Transform>().position.y = GetApp().GetHeight() * -0.5f;
-    wallBot.GetComponent<Transform>().scale = glm::vec3(GetApp().GetWidth(), 50.0f, 0.0f);
+    wallBot.GetComponent<Transform>().SetPosition(glm::vec2(0.0f, GetApp().GetHeight() * -0.5f));
+    wallBot.GetComponent<Transform>().SetScale(glm::vec3(GetApp().GetWidth(), 50.0f, 0.0f));
     wallBot.GetComponent<Rigidbody>().isKinematic = true;
     auto wallLeft = CreateEntity(PrimitiveType::Quad);
-    wallLeft.GetComponent<Transform>().position.x = GetApp().GetWidth() * -0.5f;
-    wallLeft.GetComponent<Transform>().scale = glm::vec3(50.0f, GetApp().GetHeight(), 0.0f);
+    wallLeft.GetComponent<Transform>().SetPosition(glm::vec2(GetApp().GetWidth() * -0.5f, 0.0f));
+    wallLeft.GetComponent<Transform>().SetScale(glm::vec3(50.0f, GetApp().GetHeight(), 0.0f));
     wallLeft.GetComponent<Rigidbody>().isKinematic = true;
     auto wallRight = CreateEntity(PrimitiveType::Quad);
-    wallRight.GetComponent<Transform>().position.x = GetApp().GetWidth() * 0.5f;
-    wallRight.GetComponent<Transform>().scale = glm::vec3(50.0f, GetApp().GetHeight(), 0.0f);
+    wallRight.GetComponent<Transform>().SetPosition(glm::vec2(GetApp().GetWidth() * 0.5f, 0.0f));
+    wallRight.GetComponent<Transform>().SetScale(glm::vec3(50.0f, GetApp().GetHeight(), 0.0f));
     wallRight.GetComponent<Rigidbody>().isKinematic = true;
 }
 
@@ -51,8 +51,8 @@ void HelloWorld::OnFixedUpdate(float deltaTime) {
         glm::vec2 worldPos = GetApp().GetProjectedMousePosition();
         auto box = CreateEntity(PrimitiveType::Quad);
         activeIds.push_back(box.GetID());
-        box.GetComponent<Transform>().position = glm::vec3(worldPos, 0.0f);
-        box.GetComponent<Transform>().scale = glm::vec3(15.0f, 15.0f, 0.0f);
+        box.GetComponent<Transform>().SetPosition(glm::vec3(worldPos, 0.0f));
+        box.GetComponent<Transform>().SetScale(glm::vec3(15.0f, 15.0f, 0.0f));
         box.GetComponent<Rigidbody>().velocity = glm::normalize(glm::vec3(worldPos, 0.0f)) * 1000.0f * deltaTime;
         box.GetComponent<Rigidbody>().isBounceable = true;
     }